@@ -0,0 +1,365 @@
+/**
+ * @file shared_memory_benchmark.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedMemory のプロセス間レイテンシ・スループット計測
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * @note 書込プロセス1つと読込プロセス複数を fork し、排他制御方式・構造体サイズ・読込プロセス数の組合せ毎に計測する。
+ * @n 書込側は先頭に通番と書込直前の時刻(CLOCK_MONOTONIC)を埋め込み、読込側は新しい通番を読み取った時刻との差を片道レイテンシとする。
+ * @n 結果は1組合せ1行の CSV で標準出力に出力する。
+ * @n 
+ * @n 使用方法
+ * @n shared_memory_benchmark [--modes SEQLOCK,FUTEX,...] [--sizes 64,4096,...] [--readers 1,2,...] [--cores 0,1,2] [--duration_msec 200] [--interval_usec 0] [--statistics 0]
+ * @n --cores を指定した場合、書込プロセスを先頭のコアに、読込プロセスを2番目以降のコアに順に固定する。
+ * @n --interval_usec を指定した場合、書込側はその周期で書き込む(省略時は最大速度)。
+ * @n 最大速度で書き込む場合、SEQLOCK 等の読込側は書込中の再試行を繰り返して1件も読み取れないことがある。
+ * @n 読込件数が 0 の組合せでは reads_per_sec_per_reader とレイテンシの各列を空欄で出力するため、読込側を評価する場合は --interval_usec で書込周期を指定すること。
+ * @n --statistics 1 を指定した場合、ロック統計(MapOption::statistics)を有効にして計測する。統計記録のオーバーヘッドの確認に使用する。
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+#include <sched.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "utility/shared_memory.hpp"
+
+namespace
+{
+
+using Utility::SharedMemory;
+using Clock = std::chrono::steady_clock;
+
+static constexpr uint64_t STOP_SEQUENCE = UINT64_MAX;
+
+/** 共有する構造体の先頭に埋め込む計測用情報 */
+struct Stamp
+{
+    uint64_t sequence;
+    int64_t  timestamp;                                 /**! 書込直前の時刻(ナノ秒) */
+};
+
+/** 読込プロセスの集計結果 パイプで親プロセスへ送る。 */
+struct ReaderResult
+{
+    uint64_t reads;
+    double   elapsed_sec;
+    uint64_t sample_count;
+};
+
+struct Option
+{
+    std::vector<SharedMemory::LockType> modes;
+    std::vector<size_t> sizes;
+    std::vector<int> readers;
+    std::vector<int> cores;
+    int duration_msec;
+    int interval_usec;
+    bool statistics;
+};
+
+const std::vector<std::pair<std::string, SharedMemory::LockType>>& mode_names()
+{
+    static const std::vector<std::pair<std::string, SharedMemory::LockType>> names = {
+        { "SEMAPHORE", SharedMemory::SEMAPHORE }, { "SEQLOCK", SharedMemory::SEQLOCK }, { "NONE", SharedMemory::NONE },
+        { "FUTEX", SharedMemory::FUTEX }, { "TRIPLE_BUFFER", SharedMemory::TRIPLE_BUFFER }, { "RW_LOCK", SharedMemory::RW_LOCK }
+    };
+    return names;
+}
+
+std::string mode_name(const SharedMemory::LockType& mode)
+{
+    for(const auto& name : mode_names())
+        if(name.second == mode)
+            return name.first;
+    return "UNKNOWN";
+}
+
+std::vector<std::string> split(const std::string& text)
+{
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while(std::getline(ss, item, ','))
+        if(!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+Option parse(int argc, char* argv[])
+{
+    Option option;
+    option.modes   = { SharedMemory::SEMAPHORE, SharedMemory::SEQLOCK, SharedMemory::FUTEX, SharedMemory::TRIPLE_BUFFER, SharedMemory::RW_LOCK };
+    option.sizes   = { 64, 1024, 16 * 1024, 256 * 1024, 1024 * 1024, 16 * 1024 * 1024 };
+    option.readers = { 1, 2 };
+    option.duration_msec = 200;
+    option.interval_usec = 0;
+    option.statistics    = false;
+    for(int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string key   = argv[i];
+        std::string value = argv[i + 1];
+        if(key == "--modes")
+        {
+            option.modes.clear();
+            for(const auto& item : split(value))
+            {
+                auto it = std::find_if(mode_names().begin(), mode_names().end(), [&](const std::pair<std::string, SharedMemory::LockType>& name){ return name.first == item; });
+                if(it == mode_names().end())
+                    throw std::runtime_error("unknown lock type : " + item);
+                option.modes.push_back(it->second);
+            }
+        }
+        else if(key == "--sizes")
+        {
+            option.sizes.clear();
+            for(const auto& item : split(value))
+                option.sizes.push_back(std::stoul(item));
+        }
+        else if(key == "--readers")
+        {
+            option.readers.clear();
+            for(const auto& item : split(value))
+                option.readers.push_back(std::stoi(item));
+        }
+        else if(key == "--cores")
+        {
+            option.cores.clear();
+            for(const auto& item : split(value))
+                option.cores.push_back(std::stoi(item));
+        }
+        else if(key == "--duration_msec")
+            option.duration_msec = std::stoi(value);
+        else if(key == "--interval_usec")
+            option.interval_usec = std::stoi(value);
+        else if(key == "--statistics")
+            option.statistics = (std::stoi(value) != 0);
+        else
+            throw std::runtime_error("unknown option : " + key);
+    }
+    return option;
+}
+
+void pin(const Option& option, const size_t& index)
+{
+    if(option.cores.empty())
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(option.cores[index % option.cores.size()], &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+int64_t now_nsec()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void write_all(const int& fd, const void* data, size_t size)
+{
+    const char* p = (const char*)data;
+    while(size > 0)
+    {
+        ssize_t n = write(fd, p, size);
+        if(n <= 0)
+            _exit(1);
+        p += n;
+        size -= n;
+    }
+}
+
+bool read_all(const int& fd, void* data, size_t size)
+{
+    char* p = (char*)data;
+    while(size > 0)
+    {
+        ssize_t n = read(fd, p, size);
+        if(n <= 0)
+            return false;
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+SharedMemory::MapOption map_option(const Option& option)
+{
+    SharedMemory::MapOption map_option;
+    map_option.statistics = option.statistics;
+    return map_option;
+}
+
+/** 読込プロセス 停止用の通番を読み取るまで新しい書込を読み続ける。 */
+void run_reader(const Option& option, const char* name, const SharedMemory::LockType& mode, const size_t& size, const int& fd)
+{
+    SharedMemory shmem(name, size, mode, map_option(option));
+    std::vector<char> buffer(size);
+    std::vector<int64_t> samples;
+    samples.reserve(1 << 20);
+    uint64_t last = 0;
+    uint32_t version = shmem.version();
+    uint64_t reads = 0;
+    auto start = Clock::now();
+    while(true)
+    {
+        if(mode != SharedMemory::SEMAPHORE && mode != SharedMemory::NONE)
+        {
+            if(!shmem.wait_for_update(version, 100))
+                continue;
+            version = shmem.version();
+        }
+        if(!shmem.try_read_range(0, buffer.data(), size, 100))
+            continue;
+        Stamp stamp;
+        std::memcpy(&stamp, buffer.data(), sizeof(Stamp));
+        if(stamp.sequence == STOP_SEQUENCE)
+            break;
+        if(stamp.sequence <= last)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        int64_t latency = now_nsec() - stamp.timestamp;
+        if(reads++ == 0)
+            start = Clock::now();
+        last = stamp.sequence;
+        if(samples.size() < samples.capacity())
+            samples.push_back(latency);
+    }
+    ReaderResult result = { reads, std::chrono::duration<double>(Clock::now() - start).count(), samples.size() };
+    write_all(fd, &result, sizeof(result));
+    write_all(fd, samples.data(), samples.size() * sizeof(int64_t));
+}
+
+/** 昇順に並んだレイテンシ(ナノ秒)の百分位点をマイクロ秒で返す。標本が無い場合は空文字列を返す。 */
+std::string percentile(const std::vector<int64_t>& sorted, const double& ratio)
+{
+    if(sorted.empty())
+        return "";
+    size_t index = std::min(sorted.size() - 1, (size_t)(ratio * (sorted.size() - 1) + 0.5));
+    std::stringstream ss;
+    ss << sorted[index] / 1000.0;
+    return ss.str();
+}
+
+void run(const Option& option, const SharedMemory::LockType& mode, const size_t& size, const int& reader_count)
+{
+    std::string name = "BENCH_SM_" + std::to_string(getpid());
+    size_t payload = std::max(size, sizeof(Stamp));
+    SharedMemory shmem(name.c_str(), payload, mode, map_option(option));
+    std::vector<char> buffer(payload, 0);
+    shmem.try_write_range(0, buffer.data(), payload);
+
+    std::vector<pid_t> pids;
+    std::vector<int> fds;
+    for(int i = 0; i < reader_count; i++)
+    {
+        int fd[2];
+        if(pipe(fd) != 0)
+            throw std::runtime_error("pipe failed.");
+        pid_t pid = fork();
+        if(pid == 0)
+        {
+            close(fd[0]);
+            pin(option, i + 1);
+            run_reader(option, name.c_str(), mode, payload, fd[1]);
+            _exit(0);
+        }
+        close(fd[1]);
+        pids.push_back(pid);
+        fds.push_back(fd[0]);
+    }
+
+    // 読込側の接続を待ってから計測を開始する。
+    pin(option, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    uint64_t writes = 0;
+    auto start    = Clock::now();
+    auto end_time = start + std::chrono::milliseconds(option.duration_msec);
+    auto next     = start;
+    while(Clock::now() < end_time)
+    {
+        Stamp stamp = { ++writes, now_nsec() };
+        std::memcpy(buffer.data(), &stamp, sizeof(Stamp));
+        shmem.try_write_range(0, buffer.data(), payload);
+        if(option.interval_usec > 0)
+        {
+            next += std::chrono::microseconds(option.interval_usec);
+            while(Clock::now() < next)
+                ;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    Stamp stop = { STOP_SEQUENCE, now_nsec() };
+    std::memcpy(buffer.data(), &stop, sizeof(Stamp));
+    shmem.try_write_range(0, buffer.data(), payload);
+
+    std::vector<int64_t> samples;
+    uint64_t reads = 0;
+    double read_elapsed = 0.0;
+    for(size_t i = 0; i < fds.size(); i++)
+    {
+        ReaderResult result;
+        if(read_all(fds[i], &result, sizeof(result)))
+        {
+            size_t offset = samples.size();
+            samples.resize(offset + result.sample_count);
+            if(!read_all(fds[i], samples.data() + offset, result.sample_count * sizeof(int64_t)))
+                samples.resize(offset);
+            reads += result.reads;
+            read_elapsed = std::max(read_elapsed, result.elapsed_sec);
+        }
+        close(fds[i]);
+        waitpid(pids[i], nullptr, 0);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double write_rate = writes / elapsed;
+    // 読込件数が 0 の場合は 0 と区別できるよう読込速度を空欄にする。
+    std::string read_rate = (reads > 0 && read_elapsed > 0.0) ? std::to_string((uint64_t)(reads / read_elapsed / reader_count)) : "";
+    std::cout << mode_name(mode) << "," << payload << "," << reader_count << "," << (option.statistics ? 1 : 0) << ","
+              << writes << "," << (uint64_t)write_rate << "," << reads << "," << read_rate << ","
+              << write_rate * payload / (1024.0 * 1024.0) << ","
+              << percentile(samples, 0.50) << "," << percentile(samples, 0.90) << "," << percentile(samples, 0.99) << ","
+              << percentile(samples, 0.999) << "," << percentile(samples, 1.0) << std::endl;
+    if(samples.empty())
+        std::cerr << mode_name(mode) << " payload=" << payload << " readers=" << reader_count
+                  << " : no reads completed. the writer may be starving readers; set --interval_usec." << std::endl;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    Option option;
+    try
+    {
+        option = parse(argc, argv);
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "mode,payload_bytes,readers,statistics,writes,writes_per_sec,reads,reads_per_sec_per_reader,write_mb_per_sec,"
+              << "latency_p50_usec,latency_p90_usec,latency_p99_usec,latency_p999_usec,latency_max_usec" << std::endl;
+    for(const auto& mode : option.modes)
+        for(const auto& size : option.sizes)
+            for(const auto& reader_count : option.readers)
+                run(option, mode, size, reader_count);
+    return 0;
+}
@@ -0,0 +1,324 @@
+/**
+ * @file event_loop.hpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 複数のソケット・タイマーを1スレッドで処理する @ref Utility::EventLoop クラスの定義ヘッダー
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _UTILITY_EVENT_LOOP_HPP_
+#define _UTILITY_EVENT_LOOP_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "utility/udp_socket.hpp"
+#include "utility/tcp_socket.hpp"
+
+namespace Utility
+{
+
+/**
+ * @class Utility::EventLoop
+ * @brief epoll による複数ソケット・タイマーのイベントループ (Linux 専用)
+ *
+ * @note ソケット毎に受信スレッドを立てる代わりに、1つの epoll インスタンスに登録して1スレッドで処理する。
+ * @n 登録はエッジトリガーで行い、登録したソケットはノンブロッキングに変更する。
+ * @n ハンドラは受信できた場合に true、受信するデータがなくなった場合に false を返す。
+ * @n ループは false が返るまで同じハンドラを呼び出して取りこぼしを防ぐ。
+ * @n 1回の通知で呼び出す回数には上限を設け、上限に達したハンドラは次の周回で続きを呼び出すことで、
+ * @n 高レートのソケットが他のソケットを待たせ続けないようにする。
+ * @n コア数に応じて複数のインスタンスを生成し、それぞれを別スレッド・別コアで run することもできる。
+ * @n ソケット・タイマーの登録・解除は run 開始前、又はそのループのハンドラ内から行うこと。
+ *
+ * @example test/utility/event_loop/test_event_loop.cpp
+ */
+class EventLoop final
+{
+public:
+    /** ソケットの受信ハンドラ 受信できた場合は true、受信するデータがなくなった場合は false を返す。 */
+    using Handler = std::function<bool()>;
+    /** タイマーのハンドラ */
+    using TimerHandler = std::function<void()>;
+
+private:
+    static constexpr int MAX_EVENTS   = 64;             /**! 1回の epoll_wait で取得する最大イベント数 */
+    static constexpr int DRAIN_BUDGET = 16;             /**! 1回の通知でハンドラを呼び出す最大回数 */
+
+    struct Entry
+    {
+        int fd;
+        bool is_timer;
+        Handler handler;
+        TimerHandler timer_handler;
+    };
+
+    int epoll_fd_;
+    int wakeup_fd_;
+    int core_;
+    std::atomic<bool> is_stop_requested_;               /**! stop による終了要求 run の開始前に要求された場合も保持する */
+    std::unordered_map<int, std::shared_ptr<Entry>> entries_;
+    std::vector<std::shared_ptr<Entry>> pending_;       /**! 呼出上限に達し、未受信のデータが残っている可能性があるエントリ */
+    std::vector<std::shared_ptr<Entry>> ready_;
+
+    static void throw_error(const char* operation)
+    {
+        std::stringstream ss;
+        ss << operation << " failed. error code : " << errno << std::endl;
+        throw std::runtime_error(ss.str());
+    }
+
+    void register_entry(const std::shared_ptr<Entry>& entry)
+    {
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events  = EPOLLIN | EPOLLET;
+        event.data.fd = entry->fd;
+        if(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, entry->fd, &event) != 0)
+            throw_error("epoll_ctl");
+        entries_[entry->fd] = entry;
+    }
+
+    void dispatch(const std::shared_ptr<Entry>& entry)
+    {
+        // 解除済みのエントリは呼び出さない。
+        auto it = entries_.find(entry->fd);
+        if(it == entries_.end() || it->second != entry)
+            return;
+        if(entry->is_timer)
+        {
+            uint64_t expirations;
+            if(read(entry->fd, &expirations, sizeof(expirations)) == sizeof(expirations))
+                entry->timer_handler();
+            return;
+        }
+        for(int i = 0; i < DRAIN_BUDGET; i++)
+            if(!entry->handler())
+                return;
+        pending_.push_back(entry);
+    }
+
+public:
+
+    /**
+     * @fn EventLoop
+     * @brief コンストラクタ
+     *
+     * @param int core run を実行するスレッドを固定するコア番号(省略可能) 負の値の場合は固定しない。
+     */
+    explicit EventLoop(const int& core = -1)
+     :  epoll_fd_(epoll_create1(EPOLL_CLOEXEC)), wakeup_fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), core_(core), is_stop_requested_(false)
+    {
+        if(epoll_fd_ == -1 || wakeup_fd_ == -1)
+            throw_error("epoll_create1/eventfd");
+        struct epoll_event event;
+        std::memset(&event, 0, sizeof(event));
+        event.events  = EPOLLIN;
+        event.data.fd = wakeup_fd_;
+        if(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event) != 0)
+            throw_error("epoll_ctl");
+    }
+
+    ~EventLoop()
+    {
+        for(const auto& entry : entries_)
+            if(entry.second->is_timer)
+                close(entry.first);
+        close(wakeup_fd_);
+        close(epoll_fd_);
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @fn add
+     * @brief 受信ハンドラの登録
+     *
+     * @param int fd 監視するファイルディスクリプタ(ノンブロッキングに変更する)
+     * @param Handler handler 受信可能時に呼び出すハンドラ
+     */
+    EventLoop& add(const int& fd, const Handler& handler)
+    {
+        int flags = fcntl(fd, F_GETFL, 0);
+        if(flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+            throw_error("fcntl");
+        auto entry = std::make_shared<Entry>();
+        entry->fd       = fd;
+        entry->is_timer = false;
+        entry->handler  = handler;
+        register_entry(entry);
+        return *this;
+    }
+
+    /** UdpSocket の受信ハンドラの登録 */
+    EventLoop& add(const UdpSocket& socket, const Handler& handler) { return add(socket.native_handle(), handler); }
+
+    /**
+     * @brief TcpSocket の受信ハンドラの登録
+     * @note TcpSocket::try_read は構造体の途中までしか届いていない場合、受信済みの部分を保持して false を返す。
+     * @n 残りは次回の通知時の呼出で受信されるため、ハンドラ内で待機してループ全体を止めることはない。
+     * @n 相手側の切断・受信エラーは例外で通知されるため、ハンドラ内で捕捉して @ref remove で登録解除すること。
+     */
+    EventLoop& add(const TcpSocket& socket, const Handler& handler) { return add(socket.native_handle(), handler); }
+
+    /**
+     * @fn add_timer
+     * @brief タイマーの登録
+     *
+     * @param int interval_msec 周期(ミリ秒)
+     * @param TimerHandler handler 満了時に呼び出すハンドラ
+     * @param bool is_repeat false の場合は1回のみ呼び出す(省略可能)
+     * @return int タイマーの識別子 remove で解除する。
+     * @note 処理が遅れて複数回分満了した場合も、ハンドラは1回のみ呼び出す。
+     */
+    int add_timer(const int& interval_msec, const TimerHandler& handler, const bool& is_repeat = true)
+    {
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if(fd == -1)
+            throw_error("timerfd_create");
+        struct itimerspec spec;
+        std::memset(&spec, 0, sizeof(spec));
+        spec.it_value.tv_sec  = interval_msec / 1000;
+        spec.it_value.tv_nsec = (long)(interval_msec % 1000) * 1000000;
+        if(spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+            spec.it_value.tv_nsec = 1;
+        if(is_repeat)
+            spec.it_interval = spec.it_value;
+        if(timerfd_settime(fd, 0, &spec, nullptr) != 0)
+        {
+            close(fd);
+            throw_error("timerfd_settime");
+        }
+        auto entry = std::make_shared<Entry>();
+        entry->fd            = fd;
+        entry->is_timer      = true;
+        entry->timer_handler = handler;
+        register_entry(entry);
+        return fd;
+    }
+
+    /**
+     * @fn remove
+     * @brief ソケット・タイマーの登録解除
+     *
+     * @param int fd ファイルディスクリプタ又はタイマーの識別子
+     * @note タイマーは解除時に破棄する。ソケットはクローズしない。
+     */
+    void remove(const int& fd)
+    {
+        auto it = entries_.find(fd);
+        if(it == entries_.end())
+            return;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        if(it->second->is_timer)
+            close(fd);
+        entries_.erase(it);
+    }
+
+    /** UdpSocket の登録解除 */
+    void remove(const UdpSocket& socket) { remove(socket.native_handle()); }
+
+    /** TcpSocket の登録解除 */
+    void remove(const TcpSocket& socket) { remove(socket.native_handle()); }
+
+    /**
+     * @fn run_once
+     * @brief 1回分のイベントを待機・処理する。
+     *
+     * @param int timeout_msec 待機時間(省略可能) 負の値の場合はイベントが発生するまで待機する。
+     * @return size_t 処理したイベント数
+     * @note 呼出上限に達したハンドラがある場合は待機せずに処理する。
+     */
+    size_t run_once(const int& timeout_msec = -1)
+    {
+        struct epoll_event events[MAX_EVENTS];
+        int count = epoll_wait(epoll_fd_, events, MAX_EVENTS, pending_.empty() ? timeout_msec : 0);
+        if(count < 0 && errno != EINTR)
+            throw_error("epoll_wait");
+
+        // 前回上限に達したエントリと今回通知されたエントリを処理する。処理中の解除に備えて参照を保持する。
+        ready_.swap(pending_);
+        pending_.clear();
+        for(int i = 0; i < count; i++)
+        {
+            if(events[i].data.fd == wakeup_fd_)
+            {
+                uint64_t value;
+                while(read(wakeup_fd_, &value, sizeof(value)) == sizeof(value))
+                    ;
+                continue;
+            }
+            auto it = entries_.find(events[i].data.fd);
+            if(it != entries_.end())
+                ready_.push_back(it->second);
+        }
+        size_t dispatched = ready_.size();
+        for(const auto& entry : ready_)
+            dispatch(entry);
+        ready_.clear();
+        return dispatched;
+    }
+
+    /**
+     * @fn run
+     * @brief stop が呼ばれるまでイベントを処理し続ける。
+     * @note コンストラクタでコア番号を指定した場合、呼出スレッドをそのコアに固定する。
+     */
+    void run()
+    {
+        if(core_ >= 0)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(core_, &set);
+            if(sched_setaffinity(0, sizeof(set), &set) != 0)
+                throw_error("sched_setaffinity");
+        }
+        while(!is_stop_requested_.load(std::memory_order_acquire))
+            run_once();
+        // 再度 run できるよう、終了要求を消費する。
+        is_stop_requested_.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @fn stop
+     * @brief run を終了させる。他スレッド・ハンドラ内のどちらからでも呼び出せる。
+     * @note run の開始前に呼び出した場合は、次の run が直ちに終了する。
+     */
+    void stop()
+    {
+        is_stop_requested_.store(true, std::memory_order_release);
+        uint64_t value = 1;
+        if(write(wakeup_fd_, &value, sizeof(value)) < 0)
+            return;
+    }
+
+    /**
+     * @fn size
+     * @brief 登録中のソケット・タイマーの数
+     */
+    size_t size() const { return entries_.size(); }
+};
+
+}
+
+#endif // _UTILITY_EVENT_LOOP_HPP_
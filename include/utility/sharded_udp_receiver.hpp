@@ -0,0 +1,308 @@
+/**
+ * @file sharded_udp_receiver.hpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 1つの受信ポートを複数コアで分担して受信する @ref Utility::ShardedUdpReceiver クラスの定義ヘッダー
+ * @note 本クラス作成にあたって参考にしたリンク集
+ * @n SO_REUSEPORT 関連 @link https://lwn.net/Articles/542629/ @endlink
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _UTILITY_SHARDED_UDP_RECEIVER_HPP_
+#define _UTILITY_SHARDED_UDP_RECEIVER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "utility/udp_socket.hpp"
+
+namespace Utility
+{
+
+/**
+ * @class Utility::ShardedUdpReceiver
+ * @brief SO_REUSEPORT による複数ソケット・複数スレッドでの UDP 受信 (Linux 専用)
+ *
+ * @tparam T 受信する構造体(memcpy でコピー可能な型に限る) サイズが一致しないデータグラムは破棄する。
+ * @note 同じポートに shard_count 個のソケットを SO_REUSEPORT で bind し、カーネルに受信を振り分けさせる。
+ * @n シャード毎に受信スレッドを1つずつ立て、指定があればコアに固定する。
+ * @n 受信スレッドは recvmmsg で一括受信し、シャード毎の出力キューへ書き込む。
+ * @n 出力キューはシャード毎に独立した単一生産者・単一消費者キューのため、シャード間でロック・キャッシュラインを共有しない。
+ * @n 各シャードの try_pop は同時に1スレッドからのみ呼び出すこと(異なるシャードは別スレッドから呼び出してよい)。
+ * @n steer_by_source を指定すると送信元アドレス・ポートで振り分け先を固定し、同じ送信元のデータの順序を保つ。
+ * @n 指定しない場合はカーネル既定の4タプルハッシュで振り分ける(送信元毎に固定される点は同じだが、シャード番号との対応は決まらない)。
+ *
+ * @example test/utility/sharded_udp_receiver/test_sharded_udp_receiver.cpp
+ */
+template<typename T>
+class ShardedUdpReceiver final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "ShardedUdpReceiver requires trivially copyable type.");
+
+private:
+    static constexpr int BATCH_SIZE      = 64;          /**! 1回の recvmmsg で受信する最大データグラム数 */
+    static constexpr int POLL_TIMEOUT    = 100;         /**! stop を確認する間隔(ミリ秒) */
+
+    /** シャード毎の出力キュー(単一生産者・単一消費者) */
+    class Queue final
+    {
+    private:
+        // ヒープ上では alignas(64) が保証されないため、パディングで受信スレッド側・消費側の変数を別のキャッシュラインに分ける。
+        std::atomic<uint64_t> head_;                    /**! 書込位置 受信スレッドのみ更新する */
+        uint64_t cached_tail_;                          /**! 受信スレッドが最後に参照した読込位置 */
+        char padding0_[64];
+        std::atomic<uint64_t> tail_;                    /**! 読込位置 消費側のみ更新する */
+        uint64_t cached_head_;                          /**! 消費側が最後に参照した書込位置 */
+        char padding1_[64];
+        uint64_t capacity_;
+        uint64_t mask_;
+        std::vector<T> slots_;
+
+    public:
+        explicit Queue(const uint64_t& capacity)
+         :  head_(0), cached_tail_(0), tail_(0), cached_head_(0), capacity_(capacity), mask_(capacity - 1), slots_(capacity)
+        {}
+
+        bool try_push(const T& data)
+        {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            if(head - cached_tail_ >= capacity_)
+            {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                if(head - cached_tail_ >= capacity_)
+                    return false;
+            }
+            slots_[head & mask_] = data;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t try_pop(T* data, const size_t& count)
+        {
+            uint64_t tail = tail_.load(std::memory_order_relaxed);
+            if(cached_head_ - tail < count)
+                cached_head_ = head_.load(std::memory_order_acquire);
+            size_t n = (cached_head_ - tail < count) ? (size_t)(cached_head_ - tail) : count;
+            for(size_t i = 0; i < n; i++)
+                data[i] = slots_[(tail + i) & mask_];
+            tail_.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        size_t size() const
+        {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        }
+    };
+
+    /** シャード毎のソケット・キュー・スレッド・統計 */
+    struct Shard
+    {
+        UdpSocket socket;
+        Queue queue;
+        std::thread thread;
+        std::atomic<uint64_t> received;             /**! キューへ書き込んだ数 */
+        std::atomic<uint64_t> dropped;              /**! キューが満杯のため破棄した数 */
+        std::atomic<uint64_t> invalid;              /**! サイズが一致しないため破棄した数 */
+
+        explicit Shard(const uint64_t& capacity)
+         :  queue(capacity), received(0), dropped(0), invalid(0)
+        {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::vector<int> cores_;
+    std::atomic<bool> is_running_;
+
+    static uint64_t round_up(const size_t& capacity)
+    {
+        uint64_t result = 1;
+        while(result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+    void receive(Shard& shard)
+    {
+        std::vector<T> items(BATCH_SIZE);
+        std::vector<UdpSocket::Message> messages(BATCH_SIZE);
+        for(int i = 0; i < BATCH_SIZE; i++)
+        {
+            messages[i].buffer   = reinterpret_cast<char*>(&items[i]);
+            messages[i].capacity = sizeof(T);
+        }
+        while(is_running_.load(std::memory_order_relaxed))
+        {
+            int count = shard.socket.try_read_batch(messages.data(), BATCH_SIZE);
+            uint64_t received = 0, dropped = 0, invalid = 0;
+            for(int i = 0; i < count; i++)
+            {
+                if(messages[i].truncated || messages[i].length != (int)sizeof(T))
+                    invalid++;
+                else if(shard.queue.try_push(items[i]))
+                    received++;
+                else
+                    dropped++;
+            }
+            if(received > 0)
+                shard.received.fetch_add(received, std::memory_order_relaxed);
+            if(dropped > 0)
+                shard.dropped.fetch_add(dropped, std::memory_order_relaxed);
+            if(invalid > 0)
+                shard.invalid.fetch_add(invalid, std::memory_order_relaxed);
+        }
+    }
+
+public:
+
+    /**
+     * @fn ShardedUdpReceiver
+     * @brief コンストラクタ
+     *
+     * @param int port 受信ポート
+     * @param int shard_count シャード数(受信ソケット・受信スレッド数) 通常は受信に割り当てるコア数とする。
+     * @param size_t queue_capacity シャード毎の出力キューの要素数(省略可能) 2のべき乗に切り上げられる。
+     * @param std::vector<int> cores シャード毎に受信スレッドを固定するコア番号(省略可能) 不足するシャードは固定しない。
+     * @param bool steer_by_source 送信元アドレス・ポートで振り分け先のシャードを固定する(省略可能)
+     * @note 受信スレッドは start で開始する。
+     * @n steer_by_source の振り分け先はカーネルの SO_REUSEPORT グループへの参加順で決まり、shards_[i] と一致するのは
+     * 同じポートに他のソケットが先に参加していない場合に限る。また送信元ポートの参照位置はオプションなしのIPv4ヘッダを前提とする。
+     * 詳細は @ref UdpSocket::set_reuse_port_steering を参照。
+     */
+    ShardedUdpReceiver(const int& port, const int& shard_count, const size_t& queue_capacity = 4096,
+                       const std::vector<int>& cores = std::vector<int>(), const bool& steer_by_source = true)
+     :  cores_(cores), is_running_(false)
+    {
+        if(shard_count < 1)
+            throw std::runtime_error("shard_count must be larger than 0.");
+        for(int i = 0; i < shard_count; i++)
+        {
+            shards_.emplace_back(new Shard(round_up(queue_capacity)));
+            shards_.back()->socket.set_reuse_port().set_timeout(POLL_TIMEOUT).set_listen_port(port);
+        }
+        if(steer_by_source)
+            shards_.front()->socket.set_reuse_port_steering(shard_count);
+    }
+
+    ~ShardedUdpReceiver()
+    {
+        stop();
+    }
+
+    ShardedUdpReceiver(const ShardedUdpReceiver&) = delete;
+    ShardedUdpReceiver& operator=(const ShardedUdpReceiver&) = delete;
+
+    /**
+     * @fn start
+     * @brief シャード毎の受信スレッドを開始する。
+     */
+    ShardedUdpReceiver& start()
+    {
+        if(is_running_.exchange(true))
+            return *this;
+        for(size_t i = 0; i < shards_.size(); i++)
+        {
+            Shard& shard = *shards_[i];
+            shard.thread = std::thread([this, &shard]() { receive(shard); });
+            if(i < cores_.size() && cores_[i] >= 0)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cores_[i], &set);
+                int ret = pthread_setaffinity_np(shard.thread.native_handle(), sizeof(set), &set);
+                if(ret != 0)
+                {
+                    stop();
+                    std::stringstream ss;
+                    ss << "pthread_setaffinity_np failed. error code : " << ret << std::endl;
+                    throw std::runtime_error(ss.str());
+                }
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @fn stop
+     * @brief 受信スレッドを停止する。
+     * @note 受信スレッドは受信タイムアウト毎に停止要求を確認するため、最大で約100ミリ秒待機する。
+     */
+    void stop()
+    {
+        is_running_.store(false);
+        for(auto& shard : shards_)
+            if(shard->thread.joinable())
+                shard->thread.join();
+    }
+
+    /**
+     * @fn try_pop
+     * @brief 指定したシャードの出力キューから1要素を読み込む。
+     *
+     * @param size_t shard シャード番号
+     * @param T data 読み込む構造体変数
+     * @return true  読込成功
+     * @return false キューが空のため読込失敗
+     */
+    bool try_pop(const size_t& shard, T& data)
+    {
+        return shards_[shard]->queue.try_pop(&data, 1) == 1;
+    }
+
+    /**
+     * @fn try_pop
+     * @brief 指定したシャードの出力キューから最大 count 要素を読み込む。
+     *
+     * @return size_t 読み込んだ要素数
+     */
+    size_t try_pop(const size_t& shard, T* data, const size_t& count)
+    {
+        return shards_[shard]->queue.try_pop(data, count);
+    }
+
+    /** シャード数 */
+    size_t shard_count() const { return shards_.size(); }
+
+    /** 指定したシャードの出力キューに格納されている要素数(概数) */
+    size_t size(const size_t& shard) const { return shards_[shard]->queue.size(); }
+
+    /** 指定したシャードでキューへ書き込んだ数 */
+    uint64_t received(const size_t& shard) const { return shards_[shard]->received.load(std::memory_order_relaxed); }
+
+    /** 指定したシャードでキューが満杯のため破棄した数 */
+    uint64_t dropped(const size_t& shard) const { return shards_[shard]->dropped.load(std::memory_order_relaxed); }
+
+    /** 指定したシャードでサイズが一致しないため破棄した数 */
+    uint64_t invalid(const size_t& shard) const { return shards_[shard]->invalid.load(std::memory_order_relaxed); }
+
+    /**
+     * @fn set_kernel_timestamp
+     * @brief 全シャードのソケットでカーネル受信時刻の取得を設定する。
+     * @note 有効時はシャード毎に受信待ち時間を delay_stats へ集計する。start より前に呼び出すこと。
+     */
+    ShardedUdpReceiver& set_kernel_timestamp(const bool& enable = true, const bool& use_hardware = false)
+    {
+        for(auto& shard : shards_)
+            shard->socket.set_kernel_timestamp(enable, use_hardware);
+        return *this;
+    }
+
+    /** 指定したシャードの受信待ち時間の統計 */
+    UdpSocket::DelayStats delay_stats(const size_t& shard) const { return shards_[shard]->socket.delay_stats(); }
+};
+
+}
+
+#endif // _UTILITY_SHARDED_UDP_RECEIVER_HPP_
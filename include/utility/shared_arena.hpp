@@ -0,0 +1,514 @@
+/**
+ * @file shared_arena.hpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 共有メモリ上で可変長データを扱う @ref Utility::SharedArena クラス及び共有メモリ用コンテナの定義ヘッダー
+ * @note 本クラス作成にあたって参考にしたリンク集
+ * @n 自己相対ポインタ(offset_ptr)関連 @link https://www.boost.org/doc/libs/release/doc/html/interprocess/offset_ptr.html @endlink
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _UTILITY_SHARED_ARENA_HPP_
+#define _UTILITY_SHARED_ARENA_HPP_
+
+#include <new>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+#include "utility/shared_memory.hpp"
+
+namespace Utility
+{
+
+/**
+ * @class Utility::OffsetPtr
+ * @brief 自身のアドレスからの相対位置で参照先を保持するポインタ
+ *
+ * @tparam T 参照先の型
+ * @note 共有メモリはプロセス毎に異なるアドレスにマッピングされるため、共有メモリ上には通常のポインタを置けない。
+ * @n 同じ共有メモリ上の参照先であれば、どのプロセスから見ても同じ相対位置となる。
+ */
+template<typename T>
+class OffsetPtr final
+{
+private:
+    int64_t offset_;                                    /**! 0:nullptr それ以外:参照先 - this */
+
+    void set(const T* pointer)
+    {
+        offset_ = (pointer == nullptr) ? 0 : reinterpret_cast<const char*>(pointer) - reinterpret_cast<const char*>(this);
+    }
+
+public:
+    OffsetPtr() : offset_(0) {}
+    OffsetPtr(T* pointer) { set(pointer); }
+    OffsetPtr(const OffsetPtr& other) { set(other.get()); }
+
+    OffsetPtr& operator=(const OffsetPtr& other) { set(other.get()); return *this; }
+    OffsetPtr& operator=(T* pointer) { set(pointer); return *this; }
+
+    T* get() const { return (offset_ == 0) ? nullptr : reinterpret_cast<T*>(const_cast<char*>(reinterpret_cast<const char*>(this)) + offset_); }
+    T& operator*() const { return *get(); }
+    T* operator->() const { return get(); }
+    T& operator[](const size_t& index) const { return get()[index]; }
+    explicit operator bool() const { return offset_ != 0; }
+};
+
+template<typename T> class SharedVector;
+class SharedString;
+
+/**
+ * @class Utility::SharedArena
+ * @brief 共有メモリ上に配置するサイズクラス別フリーリスト方式のメモリアロケータ
+ *
+ * @note 確保サイズを16バイト×2のべき乗のサイズクラスに切り上げ、解放した領域はサイズクラス毎のフリーリストで再利用する。
+ * @n 確保・解放は共有メモリ上のスピンロックで排他するため、複数プロセスから呼び出してよい。
+ * @n プロセス間でオブジェクトを受け渡すには @ref find_or_construct で名前を付けて生成する。
+ * @n 確保した領域(コンテナの中身を含む)の読み書きの排他は利用側で行う。
+ *
+ * @example test/utility/shared_arena/test_shared_arena.cpp
+ */
+class SharedArena final
+{
+private:
+    static constexpr int CLASS_COUNT = 40;
+    static constexpr size_t MIN_BLOCK = 16;
+    static constexpr size_t NAME_SIZE = 40;
+    static constexpr uint32_t BLOCK_MAGIC = 0x53414C42; // "SALB"
+
+    /** 共有メモリ先頭に配置する管理領域 */
+    struct alignas(64) Control
+    {
+        std::atomic<uint32_t> state;                    /**! 0:未初期化 1:初期化中 2:初期化完了 */
+        std::atomic<uint32_t> lock;                     /**! 確保・解放時のスピンロック */
+        uint32_t root_capacity;                         /**! 名前付きオブジェクトの登録数上限 */
+        uint32_t root_count;                            /**! 名前付きオブジェクトの登録数 */
+        uint64_t size;                                  /**! 管理領域を含む全体のサイズ */
+        uint64_t used;                                  /**! 管理領域先頭から未割当領域までのオフセット */
+        uint64_t free_list[CLASS_COUNT];                /**! サイズクラス毎の解放済みブロック(0:なし) */
+    };
+
+    /** 名前付きオブジェクトの登録表の1要素 */
+    struct alignas(64) Root
+    {
+        uint64_t offset;                                /**! 管理領域先頭からのオフセット */
+        uint64_t size;                                  /**! オブジェクトのサイズ */
+        char name[NAME_SIZE];                           /**! オブジェクト名 */
+    };
+
+    /** 各ブロックの先頭に配置するヘッダー */
+    struct alignas(16) Block
+    {
+        uint32_t size_class;                            /**! サイズクラス */
+        uint32_t magic;                                 /**! 不正な解放の検出用 */
+        uint64_t next;                                  /**! 解放済みの場合、次の解放済みブロックのオフセット */
+    };
+
+    SharedMemory shmem_;
+    Control* control_;
+    Root* roots_;
+
+    template<typename> friend class SharedVector;
+    friend class SharedString;
+
+    static void lock(Control* control)
+    {
+        uint32_t expected = 0;
+        while(!control->lock.compare_exchange_weak(expected, 1, std::memory_order_acquire))
+        {
+            expected = 0;
+            std::this_thread::yield();
+        }
+    }
+
+    static void unlock(Control* control)
+    {
+        control->lock.store(0, std::memory_order_release);
+    }
+
+    /** 確保サイズに対応するサイズクラス 最大のサイズクラスを超える場合は CLASS_COUNT を返す。 */
+    static int size_class(const size_t& size)
+    {
+        int size_class = 0;
+        while(size_class < CLASS_COUNT && (MIN_BLOCK << size_class) < size)
+            size_class++;
+        return size_class;
+    }
+
+    static void* allocate_unlocked(Control* control, const size_t& size)
+    {
+        int size_class = SharedArena::size_class(size);
+        if(size_class >= CLASS_COUNT)
+            return nullptr;
+
+        char* base = reinterpret_cast<char*>(control);
+        uint64_t offset = control->free_list[size_class];
+        if(offset != 0)
+        {
+            control->free_list[size_class] = reinterpret_cast<Block*>(base + offset)->next;
+        }
+        else
+        {
+            uint64_t block_size = sizeof(Block) + (MIN_BLOCK << size_class);
+            if(control->used + block_size > control->size)
+                return nullptr;
+            offset = control->used;
+            control->used += block_size;
+        }
+        Block* block = reinterpret_cast<Block*>(base + offset);
+        block->size_class = size_class;
+        block->magic      = BLOCK_MAGIC;
+        block->next       = 0;
+        return block + 1;
+    }
+
+    static void* allocate(Control* control, const size_t& size)
+    {
+        if(size_class(size) >= CLASS_COUNT)
+        {
+            std::stringstream ss;
+            ss << "shared arena allocation is too large." << std::endl;
+            ss << "required : " << size << " max : " << (MIN_BLOCK << (CLASS_COUNT - 1)) << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+        lock(control);
+        void* pointer = allocate_unlocked(control, size);
+        uint64_t remain = control->size - control->used;
+        unlock(control);
+        if(pointer == nullptr)
+        {
+            std::stringstream ss;
+            ss << "shared arena has no space." << std::endl;
+            ss << "required : " << size << " remain : " << remain << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+        return pointer;
+    }
+
+    static void deallocate(Control* control, void* pointer)
+    {
+        if(pointer == nullptr)
+            return;
+        Block* block = reinterpret_cast<Block*>(pointer) - 1;
+        if(block->magic != BLOCK_MAGIC)
+            throw std::runtime_error("shared arena deallocate : invalid pointer.\n");
+        lock(control);
+        block->magic = 0;
+        block->next  = control->free_list[block->size_class];
+        control->free_list[block->size_class] = reinterpret_cast<char*>(block) - reinterpret_cast<char*>(control);
+        unlock(control);
+    }
+
+    static size_t block_capacity(const void* pointer)
+    {
+        return MIN_BLOCK << (reinterpret_cast<const Block*>(pointer) - 1)->size_class;
+    }
+
+    Root* find_root(const char* name) const
+    {
+        for(uint32_t i = 0; i < control_->root_count; i++)
+            if(std::strncmp(roots_[i].name, name, NAME_SIZE) == 0)
+                return &roots_[i];
+        return nullptr;
+    }
+
+    void initialize(const size_t& size, const size_t& root_capacity)
+    {
+        uint32_t expected = 0;
+        if(control_->state.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+        {
+            control_->root_capacity = root_capacity;
+            control_->root_count    = 0;
+            control_->size          = size;
+            control_->used          = sizeof(Control) + root_capacity * sizeof(Root);
+            for(int i = 0; i < CLASS_COUNT; i++)
+                control_->free_list[i] = 0;
+            control_->state.store(2, std::memory_order_release);
+            return;
+        }
+        while(control_->state.load(std::memory_order_acquire) != 2)
+            std::this_thread::yield();
+
+        // 登録表の位置は登録数上限で決まるため、生成時と異なる値では接続できない。
+        if(control_->root_capacity != root_capacity)
+        {
+            std::stringstream ss;
+            ss << "shared arena root capacity mismatch." << std::endl;
+            ss << "expected : " << root_capacity << " actual : " << control_->root_capacity << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+public:
+
+    /**
+     * @fn SharedArena
+     * @brief コンストラクタ
+     *
+     * @param const char* shmem_name 共有メモリ名
+     * @param size_t size 共有メモリ全体のサイズ(管理領域を含む)
+     * @param size_t root_capacity 名前付きオブジェクトの登録数上限(省略可能)
+     * @param MapOption option マッピングオプション(省略可能)
+     * @note 既存のアリーナに接続する場合、root_capacity が生成時と異なると例外を送出する。
+     */
+    SharedArena(const char* shmem_name, const size_t& size, const size_t& root_capacity = 64, const SharedMemory::MapOption& option = SharedMemory::MapOption())
+     :  shmem_(shmem_name, size, SharedMemory::NONE, option),
+        control_(shmem_.get<Control>()),
+        roots_(reinterpret_cast<Root*>(shmem_.get<char>() + sizeof(Control)))
+    {
+        if(size < sizeof(Control) + root_capacity * sizeof(Root))
+            throw std::runtime_error("shared arena size is too small.\n");
+        initialize(size, root_capacity);
+    }
+
+    SharedArena(const SharedArena&) = delete;
+    SharedArena& operator=(const SharedArena&) = delete;
+
+    /**
+     * @fn allocate
+     * @brief 共有メモリ上の領域の確保
+     *
+     * @param size_t size 確保するバイト数
+     * @return void* 確保した領域の先頭ポインタ(16バイト境界) 共有メモリ上に保持する場合は @ref OffsetPtr に格納する。
+     * @note 空き領域が不足する場合、及び最大のサイズクラス(16バイト×2の39乗)を超える場合は例外を送出する。
+     */
+    void* allocate(const size_t& size) { return allocate(control_, size); }
+
+    /**
+     * @fn deallocate
+     * @brief @ref allocate で確保した領域の解放
+     * @note 解放した領域は同じサイズクラスの確保で再利用される。
+     */
+    void deallocate(void* pointer) { deallocate(control_, pointer); }
+
+    /**
+     * @fn find_or_construct
+     * @brief 名前付きオブジェクトの取得 未登録の場合は共有メモリ上に生成して登録する。
+     *
+     * @tparam T オブジェクトの型
+     * @param const char* name オブジェクト名(39文字以内)
+     * @param Args args 生成時にコンストラクタへ渡す引数
+     * @return T* 共有メモリ上のオブジェクトのポインタ
+     * @note 登録済みの場合は args を使用せず、既存のオブジェクトを返す。サイズが異なる場合は例外を送出する。
+     * @n 生成はロック中に行うため、T のコンストラクタで本アリーナから領域を確保してはならない。
+     */
+    template<typename T, typename... Args>
+    T* find_or_construct(const char* name, Args&&... args)
+    {
+        if(std::strlen(name) >= NAME_SIZE)
+            throw std::runtime_error(std::string("shared arena object name is too long : ") + name + "\n");
+
+        std::stringstream ss;
+        T* object = nullptr;
+        lock(control_);
+        Root* root = find_root(name);
+        if(root != nullptr && root->size == sizeof(T))
+            object = reinterpret_cast<T*>(reinterpret_cast<char*>(control_) + root->offset);
+        else if(root != nullptr)
+            ss << "shared arena object size mismatch." << std::endl << "name : " << name << " size : " << root->size << std::endl;
+        else if(control_->root_count >= control_->root_capacity)
+            ss << "shared arena root table is full." << std::endl << "capacity : " << control_->root_capacity << std::endl;
+        else if(void* pointer = allocate_unlocked(control_, sizeof(T)))
+        {
+            object = new(pointer) T(std::forward<Args>(args)...);
+            root = &roots_[control_->root_count++];
+            root->offset = reinterpret_cast<char*>(pointer) - reinterpret_cast<char*>(control_);
+            root->size   = sizeof(T);
+            std::memcpy(root->name, name, std::strlen(name) + 1);
+        }
+        else
+            ss << "shared arena has no space." << std::endl << "required : " << sizeof(T) << std::endl;
+        unlock(control_);
+
+        if(object == nullptr)
+            throw std::runtime_error(ss.str());
+        return object;
+    }
+
+    /**
+     * @fn find
+     * @brief 名前付きオブジェクトの取得
+     * @return T* 未登録の場合は nullptr
+     */
+    template<typename T>
+    T* find(const char* name)
+    {
+        lock(control_);
+        Root* root = find_root(name);
+        unlock(control_);
+        if(root == nullptr || root->size != sizeof(T))
+            return nullptr;
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(control_) + root->offset);
+    }
+
+    /**
+     * @fn used
+     * @brief 未割当領域の先頭までのサイズ(管理領域を含む)の取得
+     * @note 解放済みでフリーリストに保持されている領域も使用中として数える。
+     */
+    size_t used() const { return control_->used; }
+
+    /**
+     * @fn size
+     * @brief 共有メモリ全体のサイズの取得
+     */
+    size_t size() const { return control_->size; }
+};
+
+/**
+ * @class Utility::SharedVector
+ * @brief @ref Utility::SharedArena 上に要素を確保する可変長配列
+ *
+ * @tparam T 要素の型(memcpy でコピー可能な型に限る)
+ * @note 要素領域・アリーナへの参照を @ref OffsetPtr で保持するため、どのプロセスからも同じように操作できる。
+ * @n 本体は @ref SharedArena::find_or_construct で共有メモリ上に生成し、ローカル変数へのコピーはできない。
+ * @n 読み書きの排他は利用側で行う。
+ */
+template<typename T>
+class SharedVector final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SharedVector requires trivially copyable type.");
+
+private:
+    OffsetPtr<SharedArena::Control> arena_;
+    OffsetPtr<T> data_;
+    uint64_t size_;
+    uint64_t capacity_;
+
+public:
+    explicit SharedVector(SharedArena& arena)
+     :  arena_(arena.control_), data_(), size_(0), capacity_(0)
+    {}
+
+    SharedVector(const SharedVector&) = delete;
+    SharedVector& operator=(const SharedVector&) = delete;
+
+    ~SharedVector() { SharedArena::deallocate(arena_.get(), data_.get()); }
+
+    /**
+     * @fn reserve
+     * @brief 要素領域の事前確保
+     * @note 確保量はサイズクラスに切り上げられ、切り上げた分も容量として使用する。
+     */
+    void reserve(const size_t& capacity)
+    {
+        if(capacity <= capacity_)
+            return;
+        T* data = static_cast<T*>(SharedArena::allocate(arena_.get(), capacity * sizeof(T)));
+        if(size_ > 0)
+            std::memcpy(data, data_.get(), size_ * sizeof(T));
+        SharedArena::deallocate(arena_.get(), data_.get());
+        data_     = data;
+        capacity_ = SharedArena::block_capacity(data) / sizeof(T);
+    }
+
+    void resize(const size_t& size)
+    {
+        reserve(size);
+        if(size > size_)
+            std::memset(data_.get() + size_, 0, (size - size_) * sizeof(T));
+        size_ = size;
+    }
+
+    void push_back(const T& value)
+    {
+        if(size_ == capacity_)
+            reserve(capacity_ == 0 ? 1 : capacity_ * 2);
+        std::memcpy(data_.get() + size_, &value, sizeof(T));
+        size_++;
+    }
+
+    void pop_back() { if(size_ > 0) size_--; }
+
+    /**
+     * @fn assign
+     * @brief 配列の内容をまとめて置き換える。
+     */
+    void assign(const T* data, const size_t& count)
+    {
+        reserve(count);
+        if(count > 0)
+            std::memcpy(data_.get(), data, count * sizeof(T));
+        size_ = count;
+    }
+
+    void clear() { size_ = 0; }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    T* data() { return data_.get(); }
+    const T* data() const { return data_.get(); }
+    T& operator[](const size_t& index) { return data_[index]; }
+    const T& operator[](const size_t& index) const { return data_[index]; }
+    T* begin() { return data_.get(); }
+    T* end() { return data_.get() + size_; }
+    const T* begin() const { return data_.get(); }
+    const T* end() const { return data_.get() + size_; }
+};
+
+/**
+ * @class Utility::SharedString
+ * @brief @ref Utility::SharedArena 上に文字列を確保する可変長文字列
+ *
+ * @note 常に終端文字を保持するため、@ref c_str の戻り値をそのまま C 文字列として使用できる。
+ * @n 読み書きの排他は利用側で行う。
+ */
+class SharedString final
+{
+private:
+    SharedVector<char> buffer_;
+
+public:
+    explicit SharedString(SharedArena& arena)
+     :  buffer_(arena)
+    {}
+
+    SharedString(const SharedString&) = delete;
+    SharedString& operator=(const SharedString&) = delete;
+
+    SharedString& assign(const char* str, const size_t& length)
+    {
+        buffer_.reserve(length + 1);
+        buffer_.assign(str, length);
+        buffer_.push_back('\0');
+        return *this;
+    }
+
+    SharedString& operator=(const char* str) { return assign(str, std::strlen(str)); }
+    SharedString& operator=(const std::string& str) { return assign(str.data(), str.size()); }
+
+    SharedString& append(const char* str, const size_t& length)
+    {
+        size_t current = size();
+        buffer_.resize(current + length + 1);
+        std::memcpy(buffer_.data() + current, str, length);
+        buffer_[current + length] = '\0';
+        return *this;
+    }
+
+    SharedString& operator+=(const char* str) { return append(str, std::strlen(str)); }
+    SharedString& operator+=(const std::string& str) { return append(str.data(), str.size()); }
+
+    void clear() { buffer_.clear(); }
+
+    size_t size() const { return buffer_.empty() ? 0 : buffer_.size() - 1; }
+    bool empty() const { return size() == 0; }
+    const char* c_str() const { return buffer_.empty() ? "" : buffer_.data(); }
+    std::string str() const { return std::string(c_str(), size()); }
+};
+
+}
+
+#endif // _UTILITY_SHARED_ARENA_HPP_
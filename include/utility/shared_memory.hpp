@@ -22,6 +22,14 @@
 #include <stdexcept>
 #include <chrono>
 #include <sstream>
+#include <atomic>
+#include <type_traits>
+#include <cstdint>
+#include <thread>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <memory>
 
 #ifdef __unix__
 #include <array>
@@ -29,6 +37,14 @@
 #include <fcntl.h>
 #include <sys/shm.h>
 #include <sys/sem.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <linux/mempolicy.h>
+#include <climits>
+#include <ctime>
 #else
 #include <stdio.h>
 #include <windows.h>
@@ -55,17 +71,234 @@ using Handle = int;
 using Handle = HANDLE;
 #endif
 
+public:
+    /** 
+     * @enum LockType 
+     * @brief 共有メモリの排他制御方式
+     * @n SEMAPHORE : セマフォ(WindowsではMutex)による排他制御。共有メモリ先頭から構造体が配置される従来のレイアウト。
+     * @n SEQLOCK   : シーケンスロックによる排他制御。読込側はカーネルに入らず、書込中の読込は自動で再試行される。
+     * @n NONE      : 排他制御なし。ヘッダーによる初期化待ち・サイズ検証のみ行い、排他は利用側で管理する。
+     * @n FUTEX     : ヘッダー内のロック変数による排他制御。短時間スピンした後、futex でカーネル内待機する。
+     * @n TRIPLE_BUFFER : 3スロットのシーケンスロックによる最新値共有。書込側は最新スロットの次のスロットへ書き込んでから公開するため、読込側を待たない。
+     * @n                 読込側はロックを取得せず最新スロットを読み込み、コピー中にそのスロットが上書きされた場合は再試行する。
+     * @n                 上書きは読込側の1回のコピー中に書込側が2回公開し、さらに次の書込を始めた場合に限られる。
+     * @n                 書込側が十分に速い場合でも読込側が待ち続けないよう、再試行は8回までとし、超えた場合はタイムアウト指定の有無に関わらず読込失敗とする。
+     * @n                 書込側同士はシーケンス番号で直列化する。読込側が複数プロセスのため、スロット番号の交換で読込側の再試行を無くす方式は採らない。
+     * @n RW_LOCK   : 読込側同士は同時に読み込める読込/書込ロック。書込側が待機中の間は新たな読込側を待たせる(書込優先)。
+     */
+    enum LockType { SEMAPHORE, SEQLOCK, NONE, FUTEX, TRIPLE_BUFFER, RW_LOCK };
+
+    /** 
+     * @enum Backend 
+     * @brief 共有メモリの生成方式
+     * @n SYSTEM_V : shmget/shmat による System V 共有メモリ(従来方式)
+     * @n POSIX    : shm_open/mmap による POSIX 共有メモリ。大きなページ使用時は hugetlbfs 上のファイルとなる。
+     * @n MAPPED_FILE : 共有メモリ名をファイルパスとした通常ファイルの mmap。全プロセス終了後もファイルに内容が残り、再起動時に引き継ぐ。
+     * @n               接続・復旧の直列化のため、同じディレクトリに "<ファイル名>.lock" を生成する(削除しない)。
+     */
+    enum Backend { SYSTEM_V, POSIX, MAPPED_FILE };
+
+    /** @enum Advice @brief madvise に渡すアクセスパターンのヒント */
+    enum Advice { ADVICE_NONE, ADVICE_SEQUENTIAL, ADVICE_RANDOM, ADVICE_WILLNEED, ADVICE_HUGEPAGE };
+
+    /**
+     * @struct MapOption
+     * @brief 共有メモリ生成時のマッピングオプション
+     * @note 大容量の共有メモリで周期処理中にページフォルトが発生しないよう、起動時に前倒しするために使用する。
+     */
+    struct MapOption
+    {
+        enum Backend backend;                           /**! 生成方式                                              */
+        bool huge_page;                                 /**! 大きなページ(SHM_HUGETLB/MAP_HUGETLB)を使用する      */
+        std::string huge_page_dir;                      /**! POSIX で大きなページを使用する場合の hugetlbfs マウント先 */
+        bool populate;                                  /**! 接続時に全ページを事前にマッピングする(MAP_POPULATE)  */
+        bool lock_memory;                               /**! mlock でスワップアウトを禁止する                      */
+        enum Advice advice;                             /**! madvise に渡すヒント                                  */
+        bool page_align;                                /**! 構造体をページ境界に配置する(既定はキャッシュライン境界) */
+        int numa_node;                                  /**! mbind で割り当てる NUMA ノード(-1 の場合は指定しない)  */
+        size_t history_depth;                           /**! 書込履歴を保持する件数(0 の場合は保持しない)          */
+        int sync_interval_msec;                         /**! MAPPED_FILE で書込時にファイルへ書き出す周期(0 の場合は切断時・sync 呼出時のみ) */
+        bool statistics;                                /**! ロック取得回数・待機時間等の統計を記録する(既定は無効) */
+        MapOption()
+         :  backend(SYSTEM_V), huge_page(false), huge_page_dir("/dev/hugepages"), populate(false), lock_memory(false), advice(ADVICE_NONE),
+            page_align(false), numa_node(-1), history_depth(0), sync_interval_msec(0), statistics(false)
+        {}
+    };
+
+    /** 待機時間ヒストグラムの区間数 */
+    static constexpr size_t STATS_BUCKETS = 24;
+
+    /**
+     * @struct Stats
+     * @brief ロック統計
+     * @note SEMAPHORE 以外の排他制御方式では共有メモリ上に記録し、接続中の全プロセスの合計値となる。
+     * @n SEMAPHORE では共有メモリ上に管理領域を持たないため、自プロセス内の合計値となる。
+     * @n 競合しなかった読込側の取得は、読込側同士で共有メモリ上の統計を奪い合わないよう read_acquisitions に自プロセス分のみ記録する。
+     * @n wait_histogram[0] は1マイクロ秒未満、wait_histogram[i] は 2^(i-1) 以上 2^i 未満マイクロ秒の待機回数を表す(最後の区間は上限なし)。
+     */
+    struct Stats
+    {
+        enum LockType lock_type;                        /**! 排他制御方式                            */
+        uint64_t buffer_size;                           /**! 構造体のサイズ                          */
+        bool is_enabled;                                /**! 統計を記録しているか(false の場合は以降の値は全て0) */
+        uint64_t acquisitions;                          /**! ロック(書込権)の取得回数                */
+        uint64_t read_acquisitions;                     /**! 読込側のロック取得回数(自プロセス分のみ) */
+        uint64_t contended;                             /**! 即時に取得できず待機した取得回数(読込側を含む) */
+        uint64_t timeouts;                              /**! タイムアウトによる取得失敗回数          */
+        uint64_t total_wait_nsec;                       /**! 待機時間の合計(ナノ秒)                  */
+        uint64_t max_hold_nsec;                         /**! 書込権の最大保持時間(ナノ秒)            */
+        uint64_t wait_histogram[STATS_BUCKETS];         /**! 待機時間の対数ヒストグラム              */
+    };
+
 private:
+    // 共有メモリ上の待機に futex_wait / futex_wake を使用する。
+    template<typename> friend class SharedQueue;
+
+    /** ロック統計の記録領域 */
+    struct Statistics
+    {
+        std::atomic<uint64_t> acquisitions;
+        std::atomic<uint64_t> contended;
+        std::atomic<uint64_t> timeouts;
+        std::atomic<uint64_t> total_wait_nsec;
+        std::atomic<uint64_t> max_hold_nsec;
+        std::atomic<uint64_t> wait_histogram[STATS_BUCKETS];
+    };
+
+    /** 
+     * SEQLOCK 等のヘッダー付きレイアウトで共有メモリ先頭に配置する管理領域
+     * 更新頻度・更新するプロセスが異なる管理情報はキャッシュラインを分け、互いに偽共有しないようにする。
+     */
+    struct alignas(64) Header
+    {
+        // 生成時のみ書き込む情報
+        std::atomic<uint32_t> magic;                    /**! 初期化完了判定用の識別子 */
+        uint32_t lock_type;                             /**! 生成時の排他制御方式     */
+        uint64_t buffer_size;                           /**! 構造体のサイズ           */
+        uint64_t data_offset;                           /**! 共有メモリ先頭から構造体までのオフセット */
+        uint64_t history_depth;                         /**! 書込履歴の保持件数 */
+        uint32_t checksum;                              /**! 上記の生成時情報のチェックサム(MAPPED_FILE の再接続時に検証する) */
+        std::atomic<uint32_t> statistics_enabled;       /**! MapOption::statistics を指定して生成・接続したプロセスがあれば 1 */
+        // 書込側が更新する情報
+        alignas(64) std::atomic<uint32_t> sequence;     /**! シーケンス番号 奇数の間は書込中 */
+        std::atomic<uint32_t> full_version;             /**! 構造体全体を最後に書き込んだ時の更新番号 */
+        std::atomic<uint32_t> latest;                   /**! TRIPLE_BUFFER 用 最新スロット番号 */
+        std::atomic<uint32_t> slot_sequence[3];         /**! TRIPLE_BUFFER 用 スロット毎のシーケンス番号 */
+        std::atomic<uint32_t> slot_version[3];          /**! TRIPLE_BUFFER 用 スロット毎の更新番号 */
+        std::atomic<uint64_t> history_count;            /**! 書込履歴の累計件数(最新の履歴番号) */
+        // 書込側・読込側の双方が更新するロック変数
+        alignas(64) std::atomic<uint32_t> lock;         /**! FUTEX 用ロック変数 0:解放 1:取得 2:取得(待機者あり) RW_LOCK では読込側の数と状態ビット */
+        std::atomic<uint32_t> writers;                  /**! RW_LOCK 用 待機中の書込側の数 */
+        // 読込側が更新する待機者数
+        alignas(64) std::atomic<uint32_t> waiters;      /**! wait_for_update で待機中の読込側の数 */
+        // ロック取得・解放時に更新する統計
+        alignas(64) Statistics statistics;              /**! ロック統計 */
+    };
+
+    /** 履歴リングの1件分のヘッダー 直後に構造体のコピーを配置する。 */
+    struct alignas(64) HistoryEntry
+    {
+        std::atomic<uint32_t> sequence;                 /**! シーケンス番号 奇数の間は書込中 */
+        uint64_t serial;                                /**! 履歴番号 1から始まる */
+        int64_t timestamp;                              /**! 書込時刻(UNIX時間 ナノ秒) */
+    };
+
+    static constexpr uint32_t HEADER_MAGIC = 0x55534D48; // "USMH"
+    static constexpr int SPIN_COUNT = 100;
+    static constexpr int TRIPLE_BUFFER_RETRY = 8;       // TRIPLE_BUFFER 読込側の再試行回数の上限
+    static constexpr uint32_t RW_WRITER   = 0x80000000; // RW_LOCK 書込側が保持中
+    static constexpr uint32_t RW_WAITING  = 0x40000000; // RW_LOCK 書込側が待機中
+    static constexpr uint32_t RW_SLEEPING = 0x20000000; // RW_LOCK futex で待機中のプロセスあり
+    static constexpr uint32_t RW_READERS  = 0x1FFFFFFF; // RW_LOCK 保持中の読込側の数
+
     Handle shmem_handle_;
     Handle mutex_handle_;
+    char* mapping_;
+    Header* header_;
+    std::atomic<uint32_t>* line_version_;
     char* data_;
     int buffer_size_;
     bool is_persistence_;
+    enum LockType lock_type_;
+    MapOption option_;
+    size_t mapping_size_;
+    std::string shmem_path_;
+    std::chrono::steady_clock::time_point last_sync_;
+    Statistics* statistics_;
+    std::shared_ptr<Statistics> local_statistics_;
+    mutable std::chrono::steady_clock::time_point hold_start_;
+    mutable uint64_t read_acquisitions_;
+    size_t slot_stride_;
+    size_t payload_offset_;
+    size_t history_offset_;
+    size_t history_stride_;
 
 #ifdef __unix__
     static uint32_t make_hash(const char* str, const size_t& size);
 #endif
     static Handle create_mutex(const char* mutex_name);
+    void initialize(const char* shmem_name, const char* mutex_name);
+#ifdef __unix__
+    bool open_system_v(const char* shmem_name);
+    bool open_posix(const char* shmem_name);
+    bool open_file(const char* shmem_name);
+    bool recover();
+    static uint32_t header_checksum(const Header* header);
+    void apply_option(const char* shmem_name);
+    static size_t huge_page_size();
+#endif
+    void detach();
+    size_t segment_size() const;
+    size_t slot_stride() const { return slot_stride_; }
+    size_t alignment() const;
+    size_t history_offset() const { return history_offset_; }
+    size_t history_stride() const { return history_stride_; }
+    HistoryEntry* history_entry(const uint64_t& serial) const;
+    void append_history(const char* source);
+    size_t read_history(uint64_t& since, char* data, const size_t& size, const size_t& max_count, int64_t* timestamps) const;
+    bool begin_sequence(uint32_t& sequence, const int& timeout_msec);
+    void end_sequence(const uint32_t& sequence);
+    void notify_update();
+    void sync_if_due();
+    bool lock(const int& timeout_msec, const bool& is_exclusive = true) const;
+    void unlock(const bool& is_exclusive = true) const;
+    bool lock_shared(const int& timeout_msec) const;
+    void unlock_shared() const;
+    bool lock_exclusive(const int& timeout_msec) const;
+    void unlock_exclusive() const;
+    void wake_all() const;
+    void record_lock(const bool& is_acquired, const std::chrono::steady_clock::time_point* wait_start, const bool& is_exclusive) const;
+    void record_unlock() const;
+    bool lock_semaphore(const Handle& mutex_handle, const int& timeout_msec, const bool& is_exclusive) const;
+    void unlock_semaphore(const Handle& mutex_handle, const bool& is_exclusive) const;
+    static void copy_stats(const Statistics* statistics, Stats& stats);
+    void compute_layout();
+    size_t payload_offset() const { return payload_offset_; }
+    size_t line_count() const;
+    void check_range(const size_t& offset, const size_t& length) const;
+    bool write_range(const size_t& offset, const void* data, const size_t& length, const int& timeout_msec);
+    char* acquire_write(uint32_t& ticket, const bool& carry_over, const int& timeout_msec);
+    void release_write(const uint32_t& ticket, const size_t& offset, const size_t& length);
+    const char* acquire_read(uint32_t& ticket, const int& timeout_msec) const;
+    bool validate_read(const char* source, const uint32_t& ticket) const;
+    void release_read() const;
+    const std::atomic<uint32_t>& read_sequence(const size_t& index) const;
+    bool read_range(const size_t& offset, void* data, const size_t& length, const int& timeout_msec) const;
+    bool read_snapshot(const size_t& offset, char* data, const size_t& length, const uint32_t* since, uint32_t& version, const int& timeout_msec) const;
+    bool read_changed(void* data, uint32_t& version, const int& timeout_msec) const;
+    void mark_changed(const size_t& offset, const size_t& length, const uint32_t& version);
+    void copy_changed(char* data, const char* source, const uint32_t& since, const uint32_t& current) const;
+    static void cpu_relax();
+    static bool futex_wait(std::atomic<uint32_t>* address, const uint32_t& expected, const std::chrono::steady_clock::time_point* deadline);
+    static void futex_wake(std::atomic<uint32_t>* address, const int& count);
+
+    template<typename T, typename M>
+    static size_t field_offset(M T::* member)
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        const T* object = reinterpret_cast<const T*>(&storage);
+        return reinterpret_cast<const char*>(&(object->*member)) - reinterpret_cast<const char*>(object);
+    }
 
 public:
 
@@ -79,6 +312,24 @@ public:
      */
     explicit SharedMemory(const char* shmem_name, const size_t& size, const char* mutex_name = "");
 
+    /**
+     * @fn SharedMemory
+     * @brief 排他制御方式を指定するコンストラクタ
+     * 
+     * @param const char* shmem_name 共有メモリ名
+     * @param int size 共有メモリでやりとりする構造体のサイズ
+     * @param enum LockType lock_type 排他制御方式
+     * @param MapOption option マッピングオプション(省略可能) 省略した場合は System V 共有メモリを使用する。
+     * @note SEQLOCK を指定した場合、セマフォは生成されず共有メモリ先頭のヘッダーのシーケンス番号で排他制御を行う。
+     * @n 書込側は1プロセスを想定しているが、複数の書込側が存在しても書込同士はシーケンス番号で排他される。
+     * @n 同名の共有メモリを異なる排他制御方式で生成済みの場合は例外を送出する。
+     * @n TRIPLE_BUFFER を指定した場合、共有メモリには構造体3つ分の領域を確保する。書込側は1プロセスを想定する。
+     * @n POSIX を指定した場合、最後に切断したプロセスのデストラクタで共有メモリが削除される。
+     * @n MAPPED_FILE を指定した場合、shmem_name をファイルパスとして扱い、最後のプロセスが切断してもファイルは削除されない。
+     * @n 他に接続中のプロセスがない状態で接続した場合、ヘッダーのチェックサム・レイアウトが一致すれば前回の内容を引き継ぎ、一致しなければ初期化する。
+     */
+    SharedMemory(const char* shmem_name, const size_t& size, const enum LockType& lock_type, const MapOption& option = MapOption());
+
     /**
      * @fn ~SharedMemory
      * @brief デストラクタ
@@ -95,6 +346,13 @@ public:
      */    
     Handle mutex() const { return mutex_handle_; }
 
+    /**
+     * @fn lock_type
+     * @brief 排他制御方式のGetterメソッド
+     * @note SEMAPHORE 以外の排他制御方式では @ref mutex の戻り値は無効なハンドルとなる。
+     */
+    enum LockType lock_type() const { return lock_type_; }
+
     /**
      * @fn wait_for_single_object
      * @brief WindowsにおけるWaitForSingleObjectのラッパーメソッド
@@ -133,6 +391,7 @@ public:
      * @note クリティカルセクションの管理のため、以下のメソッドを合わせて使用する。
      * @n @ref wait_for_single_object
      * @n @ref release_mutex 
+     * @n TRIPLE_BUFFER の場合は先頭スロットを指すため、最新値の取得には @ref try_read を使用する。
      */
     template<typename T> 
     T* get() { return (T*)data_; };
@@ -150,11 +409,7 @@ public:
     template<typename T>
     bool try_write(const T* data, const int& timeout_msec = 0)
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
-        std::memcpy(data_, data, buffer_size_);
-        release_mutex(mutex_handle_);
-        return true;
+        return write_range(0, data, buffer_size_, timeout_msec);
     }
 
     /**
@@ -170,11 +425,7 @@ public:
     template<typename T>
     bool try_read(T* data, const int& timeout_msec = 0)
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
-        std::memcpy(data, data_, buffer_size_);
-        release_mutex(mutex_handle_);
-        return true;
+        return read_range(0, data, buffer_size_, timeout_msec);
     }
 
     /**
@@ -190,11 +441,7 @@ public:
     template<typename T>
     bool try_write(const T& data, const int& timeout_msec = 0)
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
-        std::memcpy(data_, &data, buffer_size_);
-        release_mutex(mutex_handle_);
-        return true;
+        return write_range(0, &data, buffer_size_, timeout_msec);
     }
 
     /**
@@ -206,15 +453,333 @@ public:
      * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
      * @return true  読取成功
      * @return false 読取失敗
+     * @note SEQLOCK, TRIPLE_BUFFER の場合、書込中に読み取ったデータは破棄して自動で再試行する。TRIPLE_BUFFER の再試行は8回までとし、超えた場合は false を返す。
+     * @n タイムアウトで失敗した場合、data の内容は不定となる。
      */
     template<typename T>
     bool try_read(T& data, const int& timeout_msec = 0)
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
-        std::memcpy(&data, data_, buffer_size_);
-        release_mutex(mutex_handle_);
-        return true;
+        return read_range(0, &data, buffer_size_, timeout_msec);
+    }
+
+    /**
+     * @fn try_write_range
+     * @brief ローカル変数->共有メモリの一部範囲への書込試行処理
+     * 
+     * @param size_t offset 構造体先頭からの書込開始位置(バイト)
+     * @param void* data 書き込むデータの先頭ポインタ
+     * @param size_t length 書き込むバイト数
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return true  書込成功
+     * @return false 書込失敗
+     * @note 構造体全体をコピーせず、指定範囲のみを排他制御下で書き込む。
+     * @n 範囲が構造体のサイズを超える場合は例外を送出する。
+     * @n TRIPLE_BUFFER の場合は最新スロットの内容を引き継いだうえで指定範囲を上書きする。
+     */
+    bool try_write_range(const size_t& offset, const void* data, const size_t& length, const int& timeout_msec = 0);
+
+    /**
+     * @fn try_read_range
+     * @brief 共有メモリの一部範囲→ローカル変数の読取試行処理
+     * 
+     * @param size_t offset 構造体先頭からの読込開始位置(バイト)
+     * @param void* data 読み取ったデータを格納する先頭ポインタ
+     * @param size_t length 読み取るバイト数
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return true  読取成功
+     * @return false 読取失敗
+     * @note 範囲が構造体のサイズを超える場合は例外を送出する。
+     */
+    bool try_read_range(const size_t& offset, void* data, const size_t& length, const int& timeout_msec = 0) const;
+
+    /**
+     * @fn write_field
+     * @brief 構造体の1メンバのみの書込試行処理
+     * 
+     * @tparam T 共有メモリでやりとりする構造体
+     * @tparam M メンバの型
+     * @param M T::* member 書き込むメンバのメンバポインタ(例: &Sample::d_data)
+     * @param M value 書き込む値
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return true  書込成功
+     * @return false 書込失敗
+     */
+    template<typename T, typename M>
+    bool write_field(M T::* member, const M& value, const int& timeout_msec = 0)
+    {
+        return try_write_range(field_offset(member), &value, sizeof(M), timeout_msec);
+    }
+
+    /**
+     * @fn read_field
+     * @brief 構造体の1メンバのみの読取試行処理
+     * 
+     * @tparam T 共有メモリでやりとりする構造体
+     * @tparam M メンバの型
+     * @param M T::* member 読み取るメンバのメンバポインタ(例: &Sample::d_data)
+     * @param M value 読み取った値を格納する変数
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return true  読取成功
+     * @return false 読取失敗
+     */
+    template<typename T, typename M>
+    bool read_field(M T::* member, M& value, const int& timeout_msec = 0) const
+    {
+        return try_read_range(field_offset(member), &value, sizeof(M), timeout_msec);
+    }
+
+    /**
+     * @fn try_read_changed
+     * @brief 前回読込以降に更新された箇所のみの読取試行処理
+     * 
+     * @tparam T 
+     * @param T  data 読み取る共通変数構造体変数 前回読込時の内容を保持している必要がある。
+     * @param uint32_t version 前回読込時の更新番号 初回は 0 を指定する。読込成功時に今回の更新番号で上書きされる。
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return true  読取成功
+     * @return false 読取失敗
+     * @note 共有メモリをキャッシュライン(64バイト)単位で管理し、version 以降に書き込まれたキャッシュラインのみをコピーする。
+     * @n 構造体全体が書き込まれていた場合や version が古すぎる場合は全体をコピーする。
+     * @n SEQLOCK, FUTEX, TRIPLE_BUFFER, RW_LOCK で差分をコピーし、SEMAPHORE, NONE では常に全体をコピーする。
+     */
+    template<typename T>
+    bool try_read_changed(T& data, uint32_t& version, const int& timeout_msec = 0) const
+    {
+        return read_changed(&data, version, timeout_msec);
+    }
+
+    /**
+     * @fn version
+     * @brief 最後に公開された書込の更新番号の取得
+     * @note 書込の度に増加するため、前回値と比較して変化がなければ読込を省略できる。
+     * @n SEMAPHORE の場合は常に 0 を返す。
+     */
+    uint32_t version() const;
+
+    /**
+     * @fn wait_for_update
+     * @brief 書込側が新しい値を公開するまでの待機処理
+     * 
+     * @param uint32_t last_version 前回読込時の更新番号(@ref version の戻り値)
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return true  last_version 以降に書込があった
+     * @return false タイムアウト
+     * @note 共有メモリ先頭のシーケンス番号を futex で待機するため、書込直後に起床し待機中は CPU を消費しない。
+     * @n 書込側は待機者がいる場合のみ起床処理のシステムコールを発行する。
+     * @n SEMAPHORE の場合はシーケンス番号を持たないため例外を送出する。
+     */
+    bool wait_for_update(const uint32_t& last_version, const int& timeout_msec = 0) const;
+
+    /**
+     * @fn sync
+     * @brief MAPPED_FILE の内容のファイルへの書出し処理
+     * 
+     * @param bool is_async true の場合は書出しを予約するのみで完了を待たない(省略可能)
+     * @return true  成功(MAPPED_FILE 以外では何もせず true を返す)
+     * @return false msync 失敗
+     * @note 切断時には自動で書き出す。MapOption::sync_interval_msec を指定した場合は書込時に周期的に非同期で書き出す。
+     */
+    bool sync(const bool& is_async = false);
+
+    /**
+     * @fn stats
+     * @brief ロック統計の取得
+     * @note MapOption::statistics を無効にした場合は is_enabled が false となり、lock_type, buffer_size 以外が全て0となる。
+     */
+    Stats stats() const;
+
+    /**
+     * @fn reset_stats
+     * @brief ロック統計の初期化
+     * @note 共有メモリ上の統計を初期化するため、接続中の他プロセスから見た値も初期化される。
+     */
+    void reset_stats();
+
+    /**
+     * @fn read_stats
+     * @brief 読込専用でマッピングした共有メモリからのロック統計の取得
+     * 
+     * @param void* mapping マッピングした共有メモリの先頭アドレス
+     * @param size_t size マッピングしたサイズ
+     * @param Stats stats 取得した統計
+     * @return true  取得成功
+     * @return false 本クラスが生成したヘッダー付きの共有メモリではない
+     * @note 接続・生成を行わずに既存の共有メモリを一覧するツールから使用する。SEMAPHORE の共有メモリは対象外。
+     * @n MapOption::statistics を指定したプロセスが1つも無い共有メモリでは、true を返し stats.is_enabled を false とする。
+     */
+    static bool read_stats(const void* mapping, const size_t& size, Stats& stats);
+
+    /**
+     * @fn history_count
+     * @brief 書込履歴の累計件数(最新の履歴番号)の取得
+     * @note MapOption::history_depth を指定していない場合は常に 0 を返す。
+     */
+    uint64_t history_count() const { return (header_ == nullptr) ? 0 : header_->history_count.load(std::memory_order_acquire); }
+
+    /**
+     * @fn try_read_history
+     * @brief 指定した履歴番号より新しい書込履歴の一括読込処理
+     * 
+     * @tparam T 
+     * @param uint64_t since 前回読み込んだ最後の履歴番号 初回は 0 を指定する。読込後は今回読み込んだ最後の履歴番号で上書きされる。
+     * @param T* data 読み取った履歴を古い順に格納する配列
+     * @param size_t max_count 読み取る最大件数(data の要素数)
+     * @param int64_t* timestamps 各履歴の書込時刻(UNIX時間 ナノ秒)を格納する配列(省略可能)
+     * @return size_t 読み取った件数
+     * @note MapOption::history_depth を指定した場合、書込の度に構造体全体のコピーと書込時刻を履歴リングに追加する。
+     * @n 保持件数を超えて上書きされた履歴は読み飛ばすため、再起動した読込側は直近 history_depth 件から再構築できる。
+     * @n 読込側同士・書込側を待たせることはない。
+     */
+    template<typename T>
+    size_t try_read_history(uint64_t& since, T* data, const size_t& max_count, int64_t* timestamps = nullptr) const
+    {
+        check_range(0, sizeof(T));
+        return read_history(since, (char*)data, sizeof(T), max_count, timestamps);
+    }
+
+    /**
+     * @class ReadView
+     * @brief 共有メモリ上の構造体をコピーせずに参照する読込用ビュー
+     * 
+     * @tparam T 共有メモリでやりとりする構造体
+     * @note 生成時に読込権を取得し、スコープを抜けると自動で解放する。
+     * @n SEQLOCK, TRIPLE_BUFFER ではロックを取得しないため、参照中に書き込まれる可能性がある。
+     * @n 参照し終えた後に @ref torn で書込と重なっていないかを確認し、重なっていた場合は読み直す。
+     */
+    template<typename T>
+    class ReadView final
+    {
+    private:
+        const SharedMemory* owner_;
+        const T* data_;
+        uint32_t ticket_;
+
+    public:
+        ReadView(const SharedMemory* owner, const int& timeout_msec)
+         :  owner_(owner), data_(nullptr), ticket_(0)
+        {
+            owner_->check_range(0, sizeof(T));
+            data_ = reinterpret_cast<const T*>(owner_->acquire_read(ticket_, timeout_msec));
+        }
+
+        ReadView(ReadView&& other)
+         :  owner_(other.owner_), data_(other.data_), ticket_(other.ticket_)
+        {
+            other.data_ = nullptr;
+        }
+
+        ReadView(const ReadView&) = delete;
+        ReadView& operator=(const ReadView&) = delete;
+
+        ~ReadView() { release(); }
+
+        /** 読込権を取得できたかどうか タイムアウトした場合は false */
+        explicit operator bool() const { return data_ != nullptr; }
+
+        const T& operator*() const { return *data_; }
+        const T* operator->() const { return data_; }
+
+        /**
+         * @fn torn
+         * @brief 取得してから現時点までに書込と重なったかどうかの判定
+         * @return true  書込と重なったため参照した内容は不定
+         * @return false 参照した内容は一貫している
+         */
+        bool torn() const { return data_ == nullptr || !owner_->validate_read(reinterpret_cast<const char*>(data_), ticket_); }
+
+        /**
+         * @fn release
+         * @brief スコープを抜ける前に読込権を解放する。
+         */
+        void release()
+        {
+            if(data_ != nullptr)
+                owner_->release_read();
+            data_ = nullptr;
+        }
+    };
+
+    /**
+     * @class WriteView
+     * @brief 共有メモリ上の構造体をコピーせずに直接書き換える書込用ビュー
+     * 
+     * @tparam T 共有メモリでやりとりする構造体
+     * @note 生成時に書込権を取得し、スコープを抜けると自動で解放して書込内容を公開する。
+     * @n TRIPLE_BUFFER の場合は最新スロットの内容を引き継いだ書込用スロットを参照する。
+     */
+    template<typename T>
+    class WriteView final
+    {
+    private:
+        SharedMemory* owner_;
+        T* data_;
+        uint32_t ticket_;
+
+    public:
+        WriteView(SharedMemory* owner, const int& timeout_msec)
+         :  owner_(owner), data_(nullptr), ticket_(0)
+        {
+            owner_->check_range(0, sizeof(T));
+            data_ = reinterpret_cast<T*>(owner_->acquire_write(ticket_, true, timeout_msec));
+        }
+
+        WriteView(WriteView&& other)
+         :  owner_(other.owner_), data_(other.data_), ticket_(other.ticket_)
+        {
+            other.data_ = nullptr;
+        }
+
+        WriteView(const WriteView&) = delete;
+        WriteView& operator=(const WriteView&) = delete;
+
+        ~WriteView() { release(); }
+
+        /** 書込権を取得できたかどうか タイムアウトした場合は false */
+        explicit operator bool() const { return data_ != nullptr; }
+
+        T& operator*() const { return *data_; }
+        T* operator->() const { return data_; }
+
+        /**
+         * @fn release
+         * @brief スコープを抜ける前に書込権を解放し、書込内容を公開する。
+         */
+        void release()
+        {
+            if(data_ != nullptr)
+                owner_->release_write(ticket_, 0, owner_->buffer_size_);
+            data_ = nullptr;
+        }
+    };
+
+    /**
+     * @fn read_view
+     * @brief 共有メモリ上の構造体を直接参照する読込用ビューの取得
+     * 
+     * @tparam T 
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return ReadView<T> タイムアウトした場合は無効なビュー(bool 変換で false) TRIPLE_BUFFER で再試行の上限を超えた場合も無効なビューとなる。
+     * @note 参照中は FUTEX, SEMAPHORE の場合ロックを保持するため、書込側を待たせる。
+     */
+    template<typename T>
+    ReadView<T> read_view(const int& timeout_msec = 0) const
+    {
+        return ReadView<T>(this, timeout_msec);
+    }
+
+    /**
+     * @fn write_view
+     * @brief 共有メモリ上の構造体を直接書き換える書込用ビューの取得
+     * 
+     * @tparam T 
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない  
+     * @return WriteView<T> タイムアウトした場合は無効なビュー(bool 変換で false)
+     * @note ビューを保持している間は他の書込側・読込側(SEQLOCK, TRIPLE_BUFFER の読込側を除く)を待たせる。
+     */
+    template<typename T>
+    WriteView<T> write_view(const int& timeout_msec = 0)
+    {
+        return WriteView<T>(this, timeout_msec);
     }
 };
 
@@ -234,11 +799,116 @@ using Handle = int;
 using Handle = HANDLE;
 #endif
 
+public:
+    enum LockType { SEMAPHORE, SEQLOCK, NONE, FUTEX, TRIPLE_BUFFER, RW_LOCK };
+    enum Backend { SYSTEM_V, POSIX, MAPPED_FILE };
+    enum Advice { ADVICE_NONE, ADVICE_SEQUENTIAL, ADVICE_RANDOM, ADVICE_WILLNEED, ADVICE_HUGEPAGE };
+
+    struct MapOption
+    {
+        enum Backend backend;
+        bool huge_page;
+        std::string huge_page_dir;
+        bool populate;
+        bool lock_memory;
+        enum Advice advice;
+        bool page_align;
+        int numa_node;
+        size_t history_depth;
+        int sync_interval_msec;
+        bool statistics;
+        MapOption()
+         :  backend(SYSTEM_V), huge_page(false), huge_page_dir("/dev/hugepages"), populate(false), lock_memory(false), advice(ADVICE_NONE),
+            page_align(false), numa_node(-1), history_depth(0), sync_interval_msec(0), statistics(false)
+        {}
+    };
+
+    static constexpr size_t STATS_BUCKETS = 24;
+
+    struct Stats
+    {
+        enum LockType lock_type;
+        uint64_t buffer_size;
+        bool is_enabled;
+        uint64_t acquisitions;
+        uint64_t read_acquisitions;
+        uint64_t contended;
+        uint64_t timeouts;
+        uint64_t total_wait_nsec;
+        uint64_t max_hold_nsec;
+        uint64_t wait_histogram[STATS_BUCKETS];
+    };
+
 private:
+    template<typename> friend class SharedQueue;
+
+    struct Statistics
+    {
+        std::atomic<uint64_t> acquisitions;
+        std::atomic<uint64_t> contended;
+        std::atomic<uint64_t> timeouts;
+        std::atomic<uint64_t> total_wait_nsec;
+        std::atomic<uint64_t> max_hold_nsec;
+        std::atomic<uint64_t> wait_histogram[STATS_BUCKETS];
+    };
+
+    struct alignas(64) Header
+    {
+        std::atomic<uint32_t> magic;
+        uint32_t lock_type;
+        uint64_t buffer_size;
+        uint64_t data_offset;
+        uint64_t history_depth;
+        uint32_t checksum;
+        std::atomic<uint32_t> statistics_enabled;
+        alignas(64) std::atomic<uint32_t> sequence;
+        std::atomic<uint32_t> full_version;
+        std::atomic<uint32_t> latest;
+        std::atomic<uint32_t> slot_sequence[3];
+        std::atomic<uint32_t> slot_version[3];
+        std::atomic<uint64_t> history_count;
+        alignas(64) std::atomic<uint32_t> lock;
+        std::atomic<uint32_t> writers;
+        alignas(64) std::atomic<uint32_t> waiters;
+        alignas(64) Statistics statistics;
+    };
+
+    struct alignas(64) HistoryEntry
+    {
+        std::atomic<uint32_t> sequence;
+        uint64_t serial;
+        int64_t timestamp;
+    };
+
+    static constexpr uint32_t HEADER_MAGIC = 0x55534D48; // "USMH"
+    static constexpr int SPIN_COUNT = 100;
+    static constexpr int TRIPLE_BUFFER_RETRY = 8;
+    static constexpr uint32_t RW_WRITER   = 0x80000000; // RW_LOCK 書込側が保持中
+    static constexpr uint32_t RW_WAITING  = 0x40000000; // RW_LOCK 書込側が待機中
+    static constexpr uint32_t RW_SLEEPING = 0x20000000; // RW_LOCK futex で待機中のプロセスあり
+    static constexpr uint32_t RW_READERS  = 0x1FFFFFFF; // RW_LOCK 保持中の読込側の数
+
     Handle shmem_handle_;
     Handle mutex_handle_;
+    char* mapping_;
+    Header* header_;
+    std::atomic<uint32_t>* line_version_;
     char* data_;
     int buffer_size_;
+    bool is_persistence_;
+    enum LockType lock_type_;
+    MapOption option_;
+    size_t mapping_size_;
+    std::string shmem_path_;
+    std::chrono::steady_clock::time_point last_sync_;
+    Statistics* statistics_;
+    std::shared_ptr<Statistics> local_statistics_;
+    mutable std::chrono::steady_clock::time_point hold_start_;
+    mutable uint64_t read_acquisitions_;
+    size_t slot_stride_;
+    size_t payload_offset_;
+    size_t history_offset_;
+    size_t history_stride_;
 
 #ifdef __unix__
 
@@ -321,6 +991,54 @@ private:
 
 #endif
 
+    static void cpu_relax()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    static bool futex_wait(std::atomic<uint32_t>* address, const uint32_t& expected, const std::chrono::steady_clock::time_point* deadline)
+    {
+#ifdef __unix__
+        // FUTEX_WAIT_BITSET はタイムアウトを CLOCK_MONOTONIC(steady_clock)の絶対時刻として扱う。
+        struct timespec ts;
+        if(deadline != nullptr)
+        {
+            auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline->time_since_epoch()).count();
+            ts.tv_sec  = nsec / 1000000000;
+            ts.tv_nsec = nsec % 1000000000;
+        }
+        if(syscall(SYS_futex, address, FUTEX_WAIT_BITSET, expected, (deadline != nullptr) ? &ts : nullptr, nullptr, FUTEX_BITSET_MATCH_ANY) == 0)
+            return true;
+        if(errno == ETIMEDOUT)
+            return false;
+        if(errno != EAGAIN && errno != EINTR)
+        {
+            std::stringstream ss;
+            ss << "futex wait failed. error code : " << errno << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+        return true;
+#else
+        // プロセス間で使用できる futex 相当の機能がないため、スリープを挟んで再試行させる。
+        if(deadline != nullptr && std::chrono::steady_clock::now() > *deadline)
+            return false;
+        if(address->load(std::memory_order_relaxed) == expected)
+            Sleep(0);
+        return true;
+#endif
+    }
+
+    static void futex_wake(std::atomic<uint32_t>* address, const int& count)
+    {
+#ifdef __unix__
+        syscall(SYS_futex, address, FUTEX_WAKE, count, nullptr, nullptr, 0);
+#endif
+    }
+
     static Handle create_mutex(const char* mutex_name) 
     {
 #ifdef __unix__
@@ -368,40 +1086,40 @@ private:
         return mutex_handle;
     }
 
-public:
-
-    explicit SharedMemory(const char* shmem_name, const size_t& size, const char* mutex_name = "")
-     :  buffer_size_(size)
+    void initialize(const char* shmem_name, const char* mutex_name)
     {
+        if(lock_type_ == SEMAPHORE && option_.history_depth > 0)
+            throw std::runtime_error("history is not supported with SEMAPHORE lock type.");
         bool is_first = false;
+        compute_layout();
+        size_t total_size = segment_size();
+        statistics_ = nullptr;
+        read_acquisitions_ = 0;
 #ifdef __unix__
-        key_t key = make_hash(shmem_name, std::string(shmem_name).length());
-        shmem_handle_ = shmget(key, 0, 0); 
-        if(shmem_handle_ == -1)
-        {
-            is_first = true;
-            shmem_handle_ = shmget(key, buffer_size_, IPC_CREAT | IPC_EXCL | 0660);
-            if(shmem_handle_ == -1)
-            {
-                std::stringstream ss;
-                ss << "shmget failed. error code : " << errno << std::endl;
-                throw std::runtime_error(ss.str());
-            }
-        }  
-        data_ = (char*)shmat(shmem_handle_, 0, 0);
-        if(data_ == (void*)-1)
+        mutex_handle_ = -1;
+        mapping_size_ = total_size;
+        if(option_.huge_page)
         {
-            std::stringstream ss;
-            ss << "shmat failed. error code : " << errno << std::endl;
-            ss << "shared memory name       : " << shmem_name << std::endl;
-            throw std::runtime_error(ss.str());            
+            size_t page_size = huge_page_size();
+            mapping_size_ = (total_size + page_size - 1) / page_size * page_size;
         }
+        if(option_.backend == POSIX)
+            is_first = open_posix(shmem_name);
+        else if(option_.backend == MAPPED_FILE)
+            is_first = open_file(shmem_name);
+        else
+            is_first = open_system_v(shmem_name);
+        apply_option(shmem_name);
 #else
+        if(option_.backend != SYSTEM_V)
+            throw std::runtime_error("POSIX and MAPPED_FILE backends are not supported on this platform.");
+        mutex_handle_ = NULL;
+        mapping_size_ = total_size;
         std::string temp(shmem_name);
         int str_size = MultiByteToWideChar(CP_UTF8, 0, &temp[0], (int)temp.size(), NULL, 0);
         std::wstring fname(str_size, 0);
-        MultiByteToWideChar(CP_UTF8, 0, &temp[0], (int)temp.size(), &fname[0], size);
-        shmem_handle_ = CreateFileMappingW(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, 0, buffer_size_, fname.c_str());
+        MultiByteToWideChar(CP_UTF8, 0, &temp[0], (int)temp.size(), &fname[0], str_size);
+        shmem_handle_ = CreateFileMappingW(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, 0, (DWORD)total_size, fname.c_str());
         if (shmem_handle_ == 0)
         {
             std::stringstream ss;
@@ -409,8 +1127,9 @@ public:
             ss << "shmem name : " << shmem_name << std::endl;
             throw std::runtime_error(ss.str());                
         }
-        data_ = (char*)MapViewOfFile(shmem_handle_, FILE_MAP_ALL_ACCESS, 0, 0, buffer_size_);
-        if (data_ == NULL)
+        is_first = (GetLastError() != ERROR_ALREADY_EXISTS);
+        mapping_ = (char*)MapViewOfFile(shmem_handle_, FILE_MAP_ALL_ACCESS, 0, 0, total_size);
+        if (mapping_ == NULL)
         {
             std::stringstream ss;
             ss << "MapViewOfFile failed. error code : " << GetLastError()  << std::endl;
@@ -418,119 +1137,848 @@ public:
             throw std::runtime_error(ss.str());                
         }
 #endif
-        if(is_first)
-            std::memset(data_, 0, buffer_size_);
-        std::string mutex_name_str = (mutex_name!=nullptr) ? mutex_name: std::string(shmem_name) + "_MTX";
-        mutex_handle_ = create_mutex(mutex_name_str.c_str());        
-    }
+        if(lock_type_ == SEMAPHORE)
+        {
+            header_ = nullptr;
+            line_version_ = nullptr;
+            data_   = mapping_;
+            if(is_first)
+                std::memset(data_, 0, buffer_size_);
+            std::string mutex_name_str = (mutex_name!=nullptr) ? mutex_name: std::string(shmem_name) + "_MTX";
+            mutex_handle_ = create_mutex(mutex_name_str.c_str());
+            // 管理領域を持たないため、統計は自プロセス内でのみ記録する。
+            if(option_.statistics)
+            {
+                local_statistics_ = std::make_shared<Statistics>();
+                statistics_ = local_statistics_.get();
+            }
+            return;
+        }
 
-    ~SharedMemory()
-    {
-#ifdef __unix__
-        shmdt(data_);        
-        struct shmid_ds shm_ds;
-        shmctl(shmem_handle_, IPC_STAT, &shm_ds);
-        if(shm_ds.shm_nattch == 0)
+        header_ = (Header*)mapping_;
+        line_version_ = (std::atomic<uint32_t>*)(mapping_ + sizeof(Header));
+        statistics_ = option_.statistics ? &header_->statistics : nullptr;
+        data_   = mapping_ + payload_offset();
+        if(is_first)
         {
-            shmctl(shmem_handle_, IPC_RMID, NULL);
-            semctl(mutex_handle_, IPC_RMID, 0);
+            std::memset(mapping_, 0, total_size);
+            header_->lock_type   = lock_type_;
+            header_->buffer_size = buffer_size_;
+            header_->data_offset = data_ - mapping_;
+            header_->history_depth = option_.history_depth;
+            header_->checksum      = header_checksum(header_);
+            header_->magic.store(HEADER_MAGIC, std::memory_order_release);
         }
-        data_ = NULL;
-#else
-        UnmapViewOfFile(data_);
+        else
+        {
+            // 生成側プロセスのヘッダー初期化完了を待機する。
+            std::stringstream ss;
+            auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+            while(header_->magic.load(std::memory_order_acquire) != HEADER_MAGIC)
+            {
+                if(std::chrono::steady_clock::now() > end_time)
+                {
+                    ss << "shared memory header is not initialized." << std::endl;
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            if(ss.str().empty() && (header_->lock_type != (uint32_t)lock_type_ || header_->buffer_size != (uint64_t)buffer_size_))
+                ss << "shared memory was created with different lock type or size." << std::endl;
+            if(ss.str().empty() && (header_->data_offset != (uint64_t)(data_ - mapping_) || header_->history_depth != option_.history_depth))
+                ss << "shared memory was created with different layout option." << std::endl;
+            if(!ss.str().empty())
+            {
+                detach();
+                ss << "shared memory name : " << shmem_name << std::endl;
+                throw std::runtime_error(ss.str());
+            }
+        }
+        // 統計を記録するプロセスが1つでもあれば、ツールから記録中と判別できるよう印を付ける。
+        if(option_.statistics)
+            header_->statistics_enabled.store(1, std::memory_order_relaxed);
+    }
+
+#ifdef __unix__
+
+    bool open_system_v(const char* shmem_name)
+    {
+        bool is_first = false;
+        key_t key = make_hash(shmem_name, std::string(shmem_name).length());
+        shmem_handle_ = shmget(key, 0, 0); 
+        if(shmem_handle_ == -1)
+        {
+            is_first = true;
+            int flag = IPC_CREAT | IPC_EXCL | 0660;
+            if(option_.huge_page)
+                flag |= SHM_HUGETLB;
+            shmem_handle_ = shmget(key, mapping_size_, flag);
+            if(shmem_handle_ == -1)
+            {
+                std::stringstream ss;
+                ss << "shmget failed. error code : " << errno << std::endl;
+                throw std::runtime_error(ss.str());
+            }
+        }  
+        mapping_ = (char*)shmat(shmem_handle_, 0, 0);
+        if(mapping_ == (void*)-1)
+        {
+            std::stringstream ss;
+            ss << "shmat failed. error code : " << errno << std::endl;
+            ss << "shared memory name       : " << shmem_name << std::endl;
+            throw std::runtime_error(ss.str());            
+        }
+        return is_first;
+    }
+
+    bool open_posix(const char* shmem_name)
+    {
+        // 大きなページを使用する場合は hugetlbfs 上のファイルとして生成する。
+        shmem_path_ = option_.huge_page ? option_.huge_page_dir + "/" + shmem_name : std::string("/") + shmem_name;
+        auto open_file = [&](const int& flag) {
+            return option_.huge_page ? open(shmem_path_.c_str(), flag, 0660) : shm_open(shmem_path_.c_str(), flag, 0660);
+        };
+        auto fail = [&](const char* what, const bool& is_first) {
+            std::stringstream ss;
+            ss << what << " failed. error code : " << errno << std::endl;
+            ss << "shared memory name : " << shmem_name << std::endl;
+            if(shmem_handle_ != -1)
+                close(shmem_handle_);
+            if(is_first)
+                option_.huge_page ? unlink(shmem_path_.c_str()) : shm_unlink(shmem_path_.c_str());
+            throw std::runtime_error(ss.str());
+        };
+
+        while(true)
+        {
+            bool is_first = true;
+            shmem_handle_ = open_file(O_RDWR | O_CREAT | O_EXCL);
+            if(shmem_handle_ == -1 && errno == EEXIST)
+            {
+                is_first = false;
+                shmem_handle_ = open_file(O_RDWR);
+                if(shmem_handle_ == -1 && errno == ENOENT)
+                    continue;
+            }
+            if(shmem_handle_ == -1)
+                fail(option_.huge_page ? "open" : "shm_open", false);
+
+            // 接続中は共有ロックを保持し、排他ロックを取得できたプロセスを最後の切断とみなして削除する。
+            // 削除済みのファイルを開いていた場合は作り直す。
+            struct stat st;
+            if(flock(shmem_handle_, LOCK_SH) == -1 || fstat(shmem_handle_, &st) == -1)
+                fail("flock", is_first);
+            if(st.st_nlink == 0)
+            {
+                close(shmem_handle_);
+                continue;
+            }
+
+            if(is_first)
+            {
+                if(ftruncate(shmem_handle_, mapping_size_) == -1)
+                    fail("ftruncate", true);
+            }
+            else
+            {
+                // 生成側プロセスがサイズを確定するまで待機する。
+                auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+                while((size_t)st.st_size < mapping_size_)
+                {
+                    if(std::chrono::steady_clock::now() > end_time)
+                    {
+                        errno = EINVAL;
+                        fail("size check", false);
+                    }
+                    std::this_thread::yield();
+                    fstat(shmem_handle_, &st);
+                }
+            }
+
+            int flag = MAP_SHARED;
+            if(option_.populate)
+                flag |= MAP_POPULATE;
+            if(option_.huge_page)
+                flag |= MAP_HUGETLB;
+            mapping_ = (char*)mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, flag, shmem_handle_, 0);
+            if(mapping_ == MAP_FAILED)
+                fail("mmap", is_first);
+            return is_first;
+        }
+    }
+
+    bool open_file(const char* shmem_name)
+    {
+        // shmem_name をファイルパスとして通常のファイルをマッピングし、最後のプロセスが切断してもファイルは削除しない。
+        shmem_path_ = shmem_name;
+        shmem_handle_ = -1;
+        int init_handle = -1;
+        auto fail = [&](const char* what) {
+            std::stringstream ss;
+            ss << what << " failed. error code : " << errno << std::endl;
+            ss << "shared memory file : " << shmem_name << std::endl;
+            if(shmem_handle_ != -1)
+                close(shmem_handle_);
+            if(init_handle != -1)
+                close(init_handle);
+            throw std::runtime_error(ss.str());
+        };
+
+        // 接続・復旧の手順全体を "<ファイル名>.lock" の排他ロックで直列化する。
+        // flock の排他ロックから共有ロックへの切替は不可分ではなく、切替の間に他プロセスが排他ロックを取得して
+        // 接続済みのプロセスが使用中のロック変数・シーケンス番号を recover で初期化してしまうことを防ぐ。
+        // ロック用ファイルは削除すると同じ競合が起きるため、削除せずに残す。
+        init_handle = open((shmem_path_ + ".lock").c_str(), O_RDWR | O_CREAT, 0660);
+        if(init_handle == -1)
+            fail("open");
+        if(flock(init_handle, LOCK_EX) == -1)
+            fail("flock");
+
+        shmem_handle_ = open(shmem_path_.c_str(), O_RDWR | O_CREAT, 0660);
+        if(shmem_handle_ == -1)
+            fail("open");
+
+        // 排他ロックを取得できた場合は他に接続中のプロセスがないため、前回終了時の状態を検証・復旧する。
+        // 他プロセスが接続中の場合は共有ロックのみ取得し、通常の接続として扱う。
+        bool is_sole = (flock(shmem_handle_, LOCK_EX | LOCK_NB) == 0);
+        if(!is_sole && flock(shmem_handle_, LOCK_SH) == -1)
+            fail("flock");
+        struct stat st;
+        if(fstat(shmem_handle_, &st) == -1)
+            fail("fstat");
+
+        bool is_first = false;
+        if((size_t)st.st_size != mapping_size_)
+        {
+            if(!is_sole)
+            {
+                errno = EINVAL;
+                fail("size check");
+            }
+            if(ftruncate(shmem_handle_, 0) == -1 || ftruncate(shmem_handle_, mapping_size_) == -1)
+                fail("ftruncate");
+            is_first = true;
+        }
+
+        int flag = MAP_SHARED;
+        if(option_.populate)
+            flag |= MAP_POPULATE;
+        mapping_ = (char*)mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, flag, shmem_handle_, 0);
+        if(mapping_ == MAP_FAILED)
+            fail("mmap");
+
+        if(is_sole && !is_first && lock_type_ != SEMAPHORE)
+            is_first = !recover();
+        if(is_sole && flock(shmem_handle_, LOCK_SH) == -1)
+            fail("flock");
+        close(init_handle);
+        return is_first;
+    }
+
+    bool recover()
+    {
+        // ヘッダーのチェックサム・レイアウトが今回の指定と一致すれば、構造体の内容を引き継ぐ。
+        // 一致しなければ初期化し直すため、他プロセスが不完全なヘッダーで接続しないよう識別子を消しておく。
+        Header* header = (Header*)mapping_;
+        if(header->magic.load(std::memory_order_relaxed) != HEADER_MAGIC
+            || header->checksum != header_checksum(header)
+            || header->lock_type != (uint32_t)lock_type_
+            || header->buffer_size != (uint64_t)buffer_size_
+            || header->data_offset != payload_offset()
+            || header->history_depth != option_.history_depth)
+        {
+            header->magic.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+        // 異常終了したプロセスが残した排他制御の状態を解除する。
+        // 書込中に終了していた場合はシーケンス番号を偶数に戻す(構造体の内容は書込途中のものとなる)。
+        auto release = [](std::atomic<uint32_t>& sequence) {
+            uint32_t value = sequence.load(std::memory_order_relaxed);
+            if(value & 1)
+                sequence.store(value + 1, std::memory_order_relaxed);
+        };
+        header->lock.store(0, std::memory_order_relaxed);
+        header->writers.store(0, std::memory_order_relaxed);
+        header->waiters.store(0, std::memory_order_relaxed);
+        release(header->sequence);
+        for(int i = 0; i < 3; i++)
+            release(header->slot_sequence[i]);
+        for(size_t i = 0; i < option_.history_depth; i++)
+            release(((HistoryEntry*)(mapping_ + history_offset() + i * history_stride()))->sequence);
+        return true;
+    }
+
+    static uint32_t header_checksum(const Header* header)
+    {
+        char buffer[sizeof(uint32_t) + sizeof(uint64_t) * 3];
+        std::memcpy(buffer, &header->lock_type, sizeof(uint32_t));
+        std::memcpy(buffer + sizeof(uint32_t), &header->buffer_size, sizeof(uint64_t));
+        std::memcpy(buffer + sizeof(uint32_t) + sizeof(uint64_t), &header->data_offset, sizeof(uint64_t));
+        std::memcpy(buffer + sizeof(uint32_t) + sizeof(uint64_t) * 2, &header->history_depth, sizeof(uint64_t));
+        return make_hash(buffer, sizeof(buffer));
+    }
+
+    void apply_option(const char* shmem_name)
+    {
+        std::stringstream ss;
+        if(option_.numa_node >= 0)
+        {
+            // 指定した NUMA ノードのメモリのみを割り当てる方針とし、割当済みのページも移動させる。
+            unsigned long node_mask[16] = {};
+            const size_t bits = sizeof(unsigned long) * 8;
+            if((size_t)option_.numa_node >= sizeof(node_mask) * 8)
+                ss << "numa node is out of range. numa node : " << option_.numa_node << std::endl;
+            else
+            {
+                node_mask[option_.numa_node / bits] |= 1UL << (option_.numa_node % bits);
+                if(syscall(SYS_mbind, mapping_, mapping_size_, MPOL_BIND, node_mask, sizeof(node_mask) * 8 + 1, MPOL_MF_MOVE) == -1)
+                    ss << "mbind failed. error code : " << errno << std::endl;
+            }
+        }
+        if(ss.str().empty() && option_.advice != ADVICE_NONE)
+        {
+            int advice = MADV_NORMAL;
+            switch(option_.advice)
+            {
+                case ADVICE_SEQUENTIAL : advice = MADV_SEQUENTIAL; break;
+                case ADVICE_RANDOM     : advice = MADV_RANDOM;     break;
+                case ADVICE_WILLNEED   : advice = MADV_WILLNEED;   break;
+                case ADVICE_HUGEPAGE   : advice = MADV_HUGEPAGE;   break;
+                default                : break;
+            }
+            if(madvise(mapping_, mapping_size_, advice) == -1)
+                ss << "madvise failed. error code : " << errno << std::endl;
+        }
+        if(ss.str().empty() && option_.populate && option_.backend == SYSTEM_V)
+        {
+            // shmat には MAP_POPULATE 相当の指定がないため、全ページに触れてページフォルトを前倒しする。
+            size_t page_size = sysconf(_SC_PAGESIZE);
+            for(size_t i = 0; i < mapping_size_; i += page_size)
+                (void)*(volatile char*)(mapping_ + i);
+        }
+        if(ss.str().empty() && option_.lock_memory && mlock(mapping_, mapping_size_) == -1)
+            ss << "mlock failed. error code : " << errno << std::endl;
+        if(!ss.str().empty())
+        {
+            detach();
+            ss << "shared memory name : " << shmem_name << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+    static size_t huge_page_size()
+    {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string line;
+        while(std::getline(meminfo, line))
+        {
+            if(line.compare(0, 13, "Hugepagesize:") == 0)
+                return std::stoul(line.substr(13)) * 1024;
+        }
+        return 2 * 1024 * 1024;
+    }
+
+#endif
+
+    void detach()
+    {
+#ifdef __unix__
+        bool is_last;
+        if(option_.backend == MAPPED_FILE)
+        {
+            // ファイルは削除せず、未反映の内容を書き出してから切断する。
+            msync(mapping_, mapping_size_, MS_SYNC);
+            munmap(mapping_, mapping_size_);
+            is_last = (flock(shmem_handle_, LOCK_EX | LOCK_NB) == 0);
+            close(shmem_handle_);
+        }
+        else if(option_.backend == POSIX)
+        {
+            munmap(mapping_, mapping_size_);
+            is_last = (flock(shmem_handle_, LOCK_EX | LOCK_NB) == 0);
+            if(is_last)
+                option_.huge_page ? unlink(shmem_path_.c_str()) : shm_unlink(shmem_path_.c_str());
+            close(shmem_handle_);
+        }
+        else
+        {
+            shmdt(mapping_);        
+            struct shmid_ds shm_ds;
+            shmctl(shmem_handle_, IPC_STAT, &shm_ds);
+            is_last = (shm_ds.shm_nattch == 0);
+            if(is_last)
+                shmctl(shmem_handle_, IPC_RMID, NULL);
+        }
+        if(is_last && lock_type_ == SEMAPHORE && mutex_handle_ != -1)
+            semctl(mutex_handle_, IPC_RMID, 0);
+#else
+        UnmapViewOfFile(mapping_);
         if (shmem_handle_ != INVALID_HANDLE_VALUE)
         {
             CloseHandle(shmem_handle_);
             shmem_handle_ = INVALID_HANDLE_VALUE;
         }
-        CloseHandle(mutex_handle_);
-        data_ = NULL;
+        if(lock_type_ == SEMAPHORE && mutex_handle_ != NULL)
+            CloseHandle(mutex_handle_);
 #endif
+        data_ = nullptr;
     }
 
-    Handle mutex() const { return mutex_handle_; }
+    size_t segment_size() const
+    {
+        if(lock_type_ == SEMAPHORE)
+            return buffer_size_;
+        return history_offset() + option_.history_depth * history_stride();
+    }
 
-    template<typename T> 
-    T* get() { return (T*)data_; };
+    void compute_layout()
+    {
+        // ヘッダーの後ろにキャッシュライン毎の更新番号を配置し、構造体はその後ろのキャッシュライン(又はページ)境界から配置する。
+        // 構造体(TRIPLE_BUFFER の場合は3スロット)の後ろに履歴リングを配置する。
+        size_t align = alignment();
+        slot_stride_    = (buffer_size_ + align - 1) / align * align;
+        payload_offset_ = (sizeof(Header) + line_count() * sizeof(uint32_t) + align - 1) / align * align;
+        history_offset_ = payload_offset_ + ((lock_type_ == TRIPLE_BUFFER) ? 3 : 1) * slot_stride_;
+        history_stride_ = sizeof(HistoryEntry) + slot_stride_;
+    }
 
-    template<typename T>
-    bool try_write(const T* data, const int& timeout_msec = 0)
+    size_t payload_offset() const { return payload_offset_; }
+
+    size_t history_offset() const { return history_offset_; }
+
+    size_t history_stride() const { return history_stride_; }
+
+    HistoryEntry* history_entry(const uint64_t& serial) const
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
+        return (HistoryEntry*)(mapping_ + history_offset() + ((serial - 1) % option_.history_depth) * history_stride());
+    }
 
-        std::memcpy(data_, data, buffer_size_);
-        release_mutex(mutex_handle_);
-        return true;
+    void append_history(const char* source)
+    {
+        // 書込権を保持した状態で呼び出されるため、書込側同士の排他は不要。
+        // 読込側とは履歴毎のシーケンス番号で排他する。
+        if(option_.history_depth == 0)
+            return;
+        uint64_t serial = header_->history_count.load(std::memory_order_relaxed) + 1;
+        HistoryEntry* entry = history_entry(serial);
+        uint32_t sequence = entry->sequence.load(std::memory_order_relaxed);
+        entry->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry->serial    = serial;
+        entry->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        std::memcpy((char*)(entry + 1), source, buffer_size_);
+        entry->sequence.store(sequence + 2, std::memory_order_release);
+        header_->history_count.store(serial, std::memory_order_release);
     }
 
-    template<typename T>
-    bool try_read(T* data, const int& timeout_msec = 0)
+    size_t read_history(uint64_t& since, char* data, const size_t& size, const size_t& max_count, int64_t* timestamps) const
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
-        std::memcpy(data, data_, buffer_size_);
-        release_mutex(mutex_handle_);
-        return true;
+        // since より新しい履歴を古い順に読み込む。リングから溢れた履歴は読み飛ばす。
+        if(option_.history_depth == 0)
+            return 0;
+        size_t count = 0;
+        uint64_t serial = since + 1;
+        while(count < max_count)
+        {
+            uint64_t latest = header_->history_count.load(std::memory_order_acquire);
+            if(serial > latest)
+                break;
+            if(latest > option_.history_depth && serial <= latest - option_.history_depth)
+                serial = latest - option_.history_depth + 1;
+            const HistoryEntry* entry = history_entry(serial);
+            uint32_t before = entry->sequence.load(std::memory_order_acquire);
+            if((before & 1) == 0 && entry->serial == serial)
+            {
+                std::memcpy(data + count * size, (const char*)(entry + 1), size);
+                int64_t timestamp = entry->timestamp;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(entry->sequence.load(std::memory_order_relaxed) == before)
+                {
+                    if(timestamps != nullptr)
+                        timestamps[count] = timestamp;
+                    since = serial;
+                    count++;
+                    serial++;
+                    continue;
+                }
+            }
+            // 読込中に上書きされた場合は、最新の履歴数から読込位置を求め直す。
+            std::this_thread::yield();
+        }
+        return count;
     }
 
-    template<typename T>
-    bool try_write(const T& data, const int& timeout_msec = 0)
+    size_t slot_stride() const { return slot_stride_; }
+
+    size_t alignment() const
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
-        std::memcpy(data_, &data, buffer_size_);
-        release_mutex(mutex_handle_);
+        if(!option_.page_align)
+            return 64;
+#ifdef __unix__
+        return option_.huge_page ? huge_page_size() : sysconf(_SC_PAGESIZE);
+#else
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#endif
+    }
+
+    bool begin_sequence(uint32_t& sequence, const int& timeout_msec)
+    {
+        // シーケンス番号を偶数→奇数に更新できた書込側のみが書込権を得る。
+        auto wait_start = std::chrono::steady_clock::now();
+        auto end_time   = wait_start + std::chrono::milliseconds(timeout_msec);
+        bool is_waited  = false;
+        sequence = header_->sequence.load(std::memory_order_relaxed);
+        while((sequence & 1) || !header_->sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            is_waited = true;
+            if(timeout_msec > 0 && std::chrono::steady_clock::now() > end_time)
+            {
+                record_lock(false, &wait_start, true);
+                return false;
+            }
+            std::this_thread::yield();
+            sequence = header_->sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        record_lock(true, is_waited ? &wait_start : nullptr, true);
         return true;
     }
 
-    template<typename T>
-    bool try_read(T& data, const int& timeout_msec = 0)
+    void end_sequence(const uint32_t& sequence)
     {
-        if(!wait_for_single_object(mutex_handle_, timeout_msec))
-            return false;
-        std::memcpy(&data, data_, buffer_size_);
-        release_mutex(mutex_handle_);
+        record_unlock();
+        header_->sequence.store(sequence + 2, std::memory_order_release);
+        notify_update();
+    }
+
+    void notify_update()
+    {
+        if(is_persistence_ && option_.sync_interval_msec > 0)
+            sync_if_due();
+        // 待機者がいる場合のみシステムコールを発行する。
+        // シーケンス番号の更新と待機者数の読込の順序を保証するため、間に完全なフェンスを挟む。
+        if(header_ == nullptr)
+            return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(header_->waiters.load(std::memory_order_relaxed) > 0)
+            futex_wake(&header_->sequence, INT_MAX);
+    }
+
+    void sync_if_due()
+    {
+        // 前回の書出しから指定周期が経過していれば非同期で書き出す。書込側を待たせない。
+        auto now = std::chrono::steady_clock::now();
+        if(now - last_sync_ >= std::chrono::milliseconds(option_.sync_interval_msec))
+            sync(true);
+    }
+
+    bool lock(const int& timeout_msec, const bool& is_exclusive = true) const
+    {
+        if(lock_type_ == SEMAPHORE)
+            return lock_semaphore(mutex_handle_, timeout_msec, is_exclusive);
+        if(lock_type_ == NONE)
+            return true;
+        if(lock_type_ == RW_LOCK)
+            return lock_exclusive(timeout_msec);
+
+        // 競合がなければ CAS のみで取得し、カーネルには入らない。
+        std::chrono::steady_clock::time_point wait_start;
+        for(int i = 0; i < SPIN_COUNT; i++)
+        {
+            uint32_t expected = 0;
+            if(header_->lock.load(std::memory_order_relaxed) == 0 && header_->lock.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                record_lock(true, (i > 0) ? &wait_start : nullptr, is_exclusive);
+                return true;
+            }
+            if(i == 0 && statistics_ != nullptr)
+                wait_start = std::chrono::steady_clock::now();
+            cpu_relax();
+        }
+
+        // 待機者ありの状態(2)にしてから解放されるまでカーネル内で待機する。
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+        while(header_->lock.exchange(2, std::memory_order_acquire) != 0)
+        {
+            if(!futex_wait(&header_->lock, 2, (timeout_msec > 0) ? &deadline : nullptr))
+            {
+                record_lock(false, &wait_start, is_exclusive);
+                return false;
+            }
+        }
+        record_lock(true, &wait_start, is_exclusive);
         return true;
     }
 
-    bool wait_for_single_object(const Handle& mutex_handle, const int& timeout_msec = 0) const
+    void unlock(const bool& is_exclusive = true) const
+    {
+        if(lock_type_ == SEMAPHORE)
+            unlock_semaphore(mutex_handle_, is_exclusive);
+        else if(lock_type_ == FUTEX)
+        {
+            if(is_exclusive)
+                record_unlock();
+            if(header_->lock.exchange(0, std::memory_order_release) == 2)
+                futex_wake(&header_->lock, 1);
+        }
+        else if(lock_type_ == RW_LOCK)
+            unlock_exclusive();
+    }
+
+    bool lock_shared(const int& timeout_msec) const
+    {
+        if(lock_type_ != RW_LOCK)
+            return lock(timeout_msec, false);
+
+        // 書込側が保持中・待機中でなければ読込側の数を加算するだけで取得する。
+        // 書込側が待機中の場合は新たな読込側を待たせ、書込側の飢餓を防ぐ。
+        // 競合しない読込側の経路では時刻を取得しない。
+        std::chrono::steady_clock::time_point wait_start, deadline;
+        int spin = 0;
+        while(true)
+        {
+            uint32_t state = header_->lock.load(std::memory_order_relaxed);
+            if((state & (RW_WRITER | RW_WAITING)) == 0)
+            {
+                if(header_->lock.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    record_lock(true, (spin > 0) ? &wait_start : nullptr, false);
+                    return true;
+                }
+                continue;
+            }
+            if(spin == 0)
+            {
+                wait_start = std::chrono::steady_clock::now();
+                deadline   = wait_start + std::chrono::milliseconds(timeout_msec);
+            }
+            if(spin++ < SPIN_COUNT)
+            {
+                cpu_relax();
+                continue;
+            }
+            if((state & RW_SLEEPING) == 0 && !header_->lock.compare_exchange_weak(state, state | RW_SLEEPING, std::memory_order_relaxed))
+                continue;
+            if(!futex_wait(&header_->lock, state | RW_SLEEPING, (timeout_msec > 0) ? &deadline : nullptr))
+            {
+                record_lock(false, &wait_start, false);
+                return false;
+            }
+        }
+    }
+
+    void unlock_shared() const
+    {
+        if(lock_type_ != RW_LOCK)
+        {
+            unlock(false);
+            return;
+        }
+        // 最後の読込側が抜けた時点で、待機中のプロセスを起床させる。
+        uint32_t state = header_->lock.fetch_sub(1, std::memory_order_release) - 1;
+        if((state & RW_READERS) == 0 && (state & RW_SLEEPING))
+            wake_all();
+    }
+
+    bool lock_exclusive(const int& timeout_msec) const
+    {
+        // 待機中の書込側の数を数え、1つ以上あれば RW_WAITING を立てて新たな読込側を止める。
+        auto wait_start = std::chrono::steady_clock::now();
+        auto deadline   = wait_start + std::chrono::milliseconds(timeout_msec);
+        bool is_waiting  = false;
+        bool is_acquired = false;
+        int spin = 0;
+        while(true)
+        {
+            uint32_t state = header_->lock.load(std::memory_order_relaxed);
+            if((state & (RW_WRITER | RW_READERS)) == 0)
+            {
+                if(header_->lock.compare_exchange_weak(state, state | RW_WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+                {
+                    is_acquired = true;
+                    break;
+                }
+                continue;
+            }
+            if(!is_waiting)
+            {
+                header_->writers.fetch_add(1, std::memory_order_relaxed);
+                is_waiting = true;
+            }
+            if((state & RW_WAITING) == 0)
+            {
+                header_->lock.fetch_or(RW_WAITING, std::memory_order_relaxed);
+                continue;
+            }
+            if(spin++ < SPIN_COUNT)
+            {
+                cpu_relax();
+                continue;
+            }
+            if((state & RW_SLEEPING) == 0 && !header_->lock.compare_exchange_weak(state, state | RW_SLEEPING, std::memory_order_relaxed))
+                continue;
+            if(!futex_wait(&header_->lock, state | RW_SLEEPING, (timeout_msec > 0) ? &deadline : nullptr))
+                break;
+        }
+
+        // 最後の待機中の書込側であれば RW_WAITING を下ろし、止めていた読込側を再開させる。
+        if(is_waiting && header_->writers.fetch_sub(1, std::memory_order_relaxed) == 1)
+        {
+            uint32_t state = header_->lock.fetch_and(~RW_WAITING, std::memory_order_relaxed);
+            if(!is_acquired && (state & RW_SLEEPING))
+                wake_all();
+        }
+        record_lock(is_acquired, is_waiting ? &wait_start : nullptr, true);
+        return is_acquired;
+    }
+
+    void unlock_exclusive() const
+    {
+        record_unlock();
+        uint32_t state = header_->lock.fetch_and(~(RW_WRITER | RW_SLEEPING), std::memory_order_release);
+        if(state & RW_SLEEPING)
+            futex_wake(&header_->lock, INT_MAX);
+    }
+
+    void wake_all() const
+    {
+        header_->lock.fetch_and(~RW_SLEEPING, std::memory_order_relaxed);
+        futex_wake(&header_->lock, INT_MAX);
+    }
+
+    void record_lock(const bool& is_acquired, const std::chrono::steady_clock::time_point* wait_start, const bool& is_exclusive) const
+    {
+        // wait_start が nullptr の場合は待機せずに取得できたものとして扱う。
+        if(statistics_ == nullptr)
+            return;
+        if(!is_acquired)
+        {
+            statistics_->timeouts.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if(!is_exclusive && wait_start == nullptr)
+        {
+            // 競合しなかった読込側は時刻を取得せず、自プロセス内でのみ数える。
+            // 共有メモリ上の統計を更新すると、読込側同士で統計のキャッシュラインを奪い合うため。
+            read_acquisitions_++;
+            return;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if(is_exclusive)
+            statistics_->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        else
+            read_acquisitions_++;
+        if(wait_start != nullptr)
+        {
+            uint64_t wait_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(now - *wait_start).count();
+            uint64_t wait_usec = wait_nsec / 1000;
+            size_t bucket = 0;
+            while(wait_usec > 0 && bucket < STATS_BUCKETS - 1)
+            {
+                wait_usec >>= 1;
+                bucket++;
+            }
+            statistics_->contended.fetch_add(1, std::memory_order_relaxed);
+            statistics_->total_wait_nsec.fetch_add(wait_nsec, std::memory_order_relaxed);
+            statistics_->wait_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+        if(is_exclusive)
+            hold_start_ = now;
+    }
+
+    void record_unlock() const
+    {
+        // 書込権は同時に1つしか保持されないため、保持開始時刻はインスタンス毎に1つでよい。
+        if(statistics_ == nullptr)
+            return;
+        uint64_t hold_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - hold_start_).count();
+        uint64_t current   = statistics_->max_hold_nsec.load(std::memory_order_relaxed);
+        while(hold_nsec > current && !statistics_->max_hold_nsec.compare_exchange_weak(current, hold_nsec, std::memory_order_relaxed))
+            ;
+    }
+
+    bool lock_semaphore(const Handle& mutex_handle, const int& timeout_msec, const bool& is_exclusive) const
     {
 #ifdef __unix__
         using std::chrono::milliseconds;
-        using std::chrono::system_clock;
+        using std::chrono::nanoseconds;
+        using std::chrono::steady_clock;
+        using std::chrono::duration_cast;
         struct sembuf sop;
         sop.sem_num =  0;    
         sop.sem_op  = -1;
-        sop.sem_flg = (timeout_msec>0) ? IPC_NOWAIT : 0;
-
-        auto end_time = system_clock::now() + milliseconds(timeout_msec);
-        
-        while(true)
+        sop.sem_flg =  0;
+        // 統計の記録時は待機せずに1度だけ取得を試み、取得できなかった場合のみ待機時間を計測する。
+        bool is_recorded = (mutex_handle == mutex_handle_ && statistics_ != nullptr);
+        steady_clock::time_point wait_start;
+        if(is_recorded)
         {
+            sop.sem_flg = IPC_NOWAIT;
             if(semop(mutex_handle, &sop, 1) == 0)
+            {
+                record_lock(true, nullptr, is_exclusive);
                 return true;
-            else if(errno != EAGAIN)
+            }
+            sop.sem_flg = 0;
+            wait_start  = steady_clock::now();
+        }
+        auto end_time = steady_clock::now() + milliseconds(timeout_msec);
+        while(true)
+        {
+            // タイムアウト指定時は残り時間を semtimedop に渡し、カーネル内で待機する。
+            int result;
+            if(timeout_msec > 0)
+            {
+                auto remain = std::max<long long>(0, duration_cast<nanoseconds>(end_time - steady_clock::now()).count());
+                struct timespec ts;
+                ts.tv_sec  = remain / 1000000000;
+                ts.tv_nsec = remain % 1000000000;
+                result = semtimedop(mutex_handle, &sop, 1, &ts);
+            }
+            else
+                result = semop(mutex_handle, &sop, 1);
+            if(result == 0)
+            {
+                if(is_recorded)
+                    record_lock(true, &wait_start, is_exclusive);
+                return true;
+            }
+            else if(errno == EAGAIN)
+            {
+                if(is_recorded)
+                    record_lock(false, &wait_start, is_exclusive);
+                return false;
+            }
+            else if(errno != EINTR)
             {
                 std::stringstream ss;
                 ss << "semop lock failed. error code : " << errno << std::endl;
                 throw std::runtime_error(ss.str());
             }
-
-            if(system_clock::now() > end_time)
-                return false;
         }     
 #else
-        int timeout = (timeout_msec>0) ? timeout_msec : INFINITE;
-        if(WaitForSingleObject(mutex_handle, timeout) == WAIT_OBJECT_0)
+        bool is_recorded = (mutex_handle == mutex_handle_ && statistics_ != nullptr);
+        auto wait_start  = std::chrono::steady_clock::now();
+        if(is_recorded && WaitForSingleObject(mutex_handle, 0) == WAIT_OBJECT_0)
+        {
+            record_lock(true, nullptr, is_exclusive);
             return true;
-        else
-            return false;
+        }
+        int timeout = (timeout_msec>0) ? timeout_msec : INFINITE;
+        bool is_acquired = (WaitForSingleObject(mutex_handle, timeout) == WAIT_OBJECT_0);
+        if(is_recorded)
+            record_lock(is_acquired, &wait_start, is_exclusive);
+        return is_acquired;
 #endif
     }
 
-    void release_mutex(const Handle& mutex_handle) const
+    void unlock_semaphore(const Handle& mutex_handle, const bool& is_exclusive) const
     {
+        if(mutex_handle == mutex_handle_ && is_exclusive)
+            record_unlock();
 #ifdef __unix__
         struct sembuf sop;
         sop.sem_num =  0;    
@@ -546,6 +1994,542 @@ public:
         ReleaseMutex(mutex_handle);     
 #endif
     }
+
+    static void copy_stats(const Statistics* statistics, Stats& stats)
+    {
+        stats.acquisitions    = statistics->acquisitions.load(std::memory_order_relaxed);
+        stats.contended       = statistics->contended.load(std::memory_order_relaxed);
+        stats.timeouts        = statistics->timeouts.load(std::memory_order_relaxed);
+        stats.total_wait_nsec = statistics->total_wait_nsec.load(std::memory_order_relaxed);
+        stats.max_hold_nsec   = statistics->max_hold_nsec.load(std::memory_order_relaxed);
+        for(size_t i = 0; i < STATS_BUCKETS; i++)
+            stats.wait_histogram[i] = statistics->wait_histogram[i].load(std::memory_order_relaxed);
+    }
+
+    bool write_range(const size_t& offset, const void* data, const size_t& length, const int& timeout_msec)
+    {
+        uint32_t ticket;
+        char* destination = acquire_write(ticket, length < (size_t)buffer_size_, timeout_msec);
+        if(destination == nullptr)
+            return false;
+        std::memcpy(destination + offset, data, length);
+        release_write(ticket, offset, length);
+        return true;
+    }
+
+    char* acquire_write(uint32_t& ticket, const bool& carry_over, const int& timeout_msec)
+    {
+        ticket = 0;
+        if(lock_type_ == NONE)
+            return data_;
+        if(lock_type_ == SEQLOCK)
+            return begin_sequence(ticket, timeout_msec) ? data_ : nullptr;
+        if(lock_type_ == TRIPLE_BUFFER)
+        {
+            if(!begin_sequence(ticket, timeout_msec))
+                return nullptr;
+            // 最新スロットの次のスロットに書き込み、書込完了後に最新スロットとして公開する。
+            // 書込側は読込側を待たない。読込側が2回前に公開されたスロットをまだコピーしている場合は上書きするため、
+            // 読込側はスロット毎のシーケンス番号で上書きを検出して再試行する。
+            // 部分書込の場合は最新スロットの内容を引き継いでから対象範囲を上書きする。
+            uint32_t latest = header_->latest.load(std::memory_order_relaxed);
+            uint32_t index  = (latest + 1) % 3;
+            header_->slot_sequence[index].fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            char* slot = data_ + index * slot_stride();
+            if(carry_over)
+                std::memcpy(slot, data_ + latest * slot_stride(), buffer_size_);
+            return slot;
+        }
+        return lock(timeout_msec) ? data_ : nullptr;
+    }
+
+    void release_write(const uint32_t& ticket, const size_t& offset, const size_t& length)
+    {
+        if(lock_type_ == NONE)
+        {
+            append_history(data_);
+            header_->sequence.fetch_add(2, std::memory_order_release);
+            notify_update();
+            return;
+        }
+        if(lock_type_ == SEQLOCK)
+        {
+            mark_changed(offset, length, ticket + 2);
+            append_history(data_);
+            end_sequence(ticket);
+            return;
+        }
+        if(lock_type_ == TRIPLE_BUFFER)
+        {
+            uint32_t index = (header_->latest.load(std::memory_order_relaxed) + 1) % 3;
+            mark_changed(offset, length, ticket + 2);
+            append_history(data_ + index * slot_stride());
+            header_->slot_version[index].store(ticket + 2, std::memory_order_relaxed);
+            header_->slot_sequence[index].fetch_add(1, std::memory_order_release);
+            header_->latest.store(index, std::memory_order_release);
+            end_sequence(ticket);
+            return;
+        }
+        if(lock_type_ == FUTEX || lock_type_ == RW_LOCK)
+        {
+            uint32_t version = header_->sequence.load(std::memory_order_relaxed) + 2;
+            mark_changed(offset, length, version);
+            append_history(data_);
+            header_->sequence.store(version, std::memory_order_release);
+        }
+        unlock();
+        notify_update();
+    }
+
+    const char* acquire_read(uint32_t& ticket, const int& timeout_msec) const
+    {
+        ticket = 0;
+        if(lock_type_ != SEQLOCK && lock_type_ != TRIPLE_BUFFER)
+            return lock_shared(timeout_msec) ? data_ : nullptr;
+
+        // 書込中でないシーケンス番号を控え、解放時に変化していないかで読込の成否を判定する。
+        // TRIPLE_BUFFER では書込側に追従できない読込側が待ち続けないよう、再試行回数に上限を設ける。
+        auto end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+        int retry = 0;
+        while(true)
+        {
+            uint32_t index = 0;
+            if(lock_type_ == TRIPLE_BUFFER)
+                index = header_->latest.load(std::memory_order_acquire);
+            ticket = read_sequence(index).load(std::memory_order_acquire);
+            if((ticket & 1) == 0)
+                return data_ + index * slot_stride();
+            if(lock_type_ == TRIPLE_BUFFER && ++retry >= TRIPLE_BUFFER_RETRY)
+                return nullptr;
+            if(timeout_msec > 0 && std::chrono::steady_clock::now() > end_time)
+                return nullptr;
+            std::this_thread::yield();
+        }
+    }
+
+    bool validate_read(const char* source, const uint32_t& ticket) const
+    {
+        if(lock_type_ != SEQLOCK && lock_type_ != TRIPLE_BUFFER)
+            return true;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return read_sequence((source - data_) / slot_stride()).load(std::memory_order_relaxed) == ticket;
+    }
+
+    void release_read() const
+    {
+        if(lock_type_ != SEQLOCK && lock_type_ != TRIPLE_BUFFER)
+            unlock_shared();
+    }
+
+    const std::atomic<uint32_t>& read_sequence(const size_t& index) const
+    {
+        return (lock_type_ == TRIPLE_BUFFER) ? header_->slot_sequence[index] : header_->sequence;
+    }
+
+    bool read_range(const size_t& offset, void* data, const size_t& length, const int& timeout_msec) const
+    {
+        uint32_t version = 0;
+        return read_snapshot(offset, (char*)data, length, nullptr, version, timeout_msec);
+    }
+
+    bool read_snapshot(const size_t& offset, char* data, const size_t& length, const uint32_t* since, uint32_t& version, const int& timeout_msec) const
+    {
+        // since を指定した場合は、since 以降に更新されたキャッシュラインのみを data にコピーする。
+        // SEQLOCK, TRIPLE_BUFFER では読込前後でシーケンス番号が一致しなければ書込と重なったため再試行する。
+        auto end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+        int retry = 0;
+        while(true)
+        {
+            uint32_t ticket;
+            const char* source = acquire_read(ticket, timeout_msec);
+            if(source == nullptr)
+                return false;
+            uint32_t current = ticket;
+            if(lock_type_ == TRIPLE_BUFFER)
+                current = header_->slot_version[(source - data_) / slot_stride()].load(std::memory_order_relaxed);
+            else if(lock_type_ != SEQLOCK && header_ != nullptr)
+                current = header_->sequence.load(std::memory_order_relaxed);
+            if(since == nullptr || header_ == nullptr || lock_type_ == NONE)
+                std::memcpy(data, source + offset, length);
+            else if(current != *since)
+                copy_changed(data, source, *since, current);
+            bool is_valid = validate_read(source, ticket);
+            release_read();
+            if(is_valid)
+            {
+                version = current;
+                return true;
+            }
+            if(lock_type_ == TRIPLE_BUFFER && ++retry >= TRIPLE_BUFFER_RETRY)
+                return false;
+            if(timeout_msec > 0 && std::chrono::steady_clock::now() > end_time)
+                return false;
+            std::this_thread::yield();
+        }
+    }
+
+    void mark_changed(const size_t& offset, const size_t& length, const uint32_t& version)
+    {
+        // 全体書込の場合はキャッシュライン毎の更新を省略し、全体更新番号のみ更新する。
+        if(offset == 0 && length == (size_t)buffer_size_)
+        {
+            header_->full_version.store(version, std::memory_order_relaxed);
+            return;
+        }
+        if(length == 0)
+            return;
+        for(size_t i = offset / 64; i <= (offset + length - 1) / 64; i++)
+            line_version_[i].store(version, std::memory_order_relaxed);
+    }
+
+    void copy_changed(char* data, const char* source, const uint32_t& since, const uint32_t& current) const
+    {
+        // シーケンス番号の周回を考慮し、差分で前後関係を判定する。
+        auto is_newer = [&](const uint32_t& version) { return (int32_t)(version - since) > 0; };
+        if(since == 0 || (current - since) >= 0x40000000u || is_newer(header_->full_version.load(std::memory_order_relaxed)))
+        {
+            std::memcpy(data, source, buffer_size_);
+            return;
+        }
+        size_t lines = line_count();
+        for(size_t i = 0; i < lines;)
+        {
+            if(!is_newer(line_version_[i].load(std::memory_order_relaxed)))
+            {
+                i++;
+                continue;
+            }
+            size_t j = i + 1;
+            while(j < lines && is_newer(line_version_[j].load(std::memory_order_relaxed)))
+                j++;
+            size_t begin = i * 64;
+            size_t end   = std::min<size_t>(j * 64, buffer_size_);
+            std::memcpy(data + begin, source + begin, end - begin);
+            i = j;
+        }
+    }
+
+    size_t line_count() const
+    {
+        // NONE は mark_changed を呼ばないため、キャッシュライン毎の更新番号の領域を確保しない。
+        if(lock_type_ == NONE)
+            return 0;
+        return (buffer_size_ + 63) / 64;
+    }
+
+    void check_range(const size_t& offset, const size_t& length) const
+    {
+        if(offset + length > (size_t)buffer_size_)
+        {
+            std::stringstream ss;
+            ss << "access range is out of shared memory." << std::endl;
+            ss << "offset : " << offset << " length : " << length << " size : " << buffer_size_ << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+    bool read_changed(void* data, uint32_t& version, const int& timeout_msec) const
+    {
+        uint32_t since = version;
+        return read_snapshot(0, (char*)data, buffer_size_, &since, version, timeout_msec);
+    }
+
+    template<typename T, typename M>
+    static size_t field_offset(M T::* member)
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        const T* object = reinterpret_cast<const T*>(&storage);
+        return reinterpret_cast<const char*>(&(object->*member)) - reinterpret_cast<const char*>(object);
+    }
+
+public:
+
+    explicit SharedMemory(const char* shmem_name, const size_t& size, const char* mutex_name = "")
+     :  buffer_size_(size), is_persistence_(false), lock_type_(SEMAPHORE), option_()
+    {
+        initialize(shmem_name, mutex_name);
+    }
+
+    SharedMemory(const char* shmem_name, const size_t& size, const enum LockType& lock_type, const MapOption& option = MapOption())
+     :  buffer_size_(size), is_persistence_(option.backend == MAPPED_FILE), lock_type_(lock_type), option_(option)
+    {
+        initialize(shmem_name, nullptr);
+    }
+
+    ~SharedMemory()
+    {
+        detach();
+    }
+
+    Handle mutex() const { return mutex_handle_; }
+
+    enum LockType lock_type() const { return lock_type_; }
+
+    template<typename T> 
+    T* get() { return (T*)data_; };
+
+    template<typename T>
+    bool try_write(const T* data, const int& timeout_msec = 0)
+    {
+        return write_range(0, data, buffer_size_, timeout_msec);
+    }
+
+    template<typename T>
+    bool try_read(T* data, const int& timeout_msec = 0)
+    {
+        return read_range(0, data, buffer_size_, timeout_msec);
+    }
+
+    template<typename T>
+    bool try_write(const T& data, const int& timeout_msec = 0)
+    {
+        return write_range(0, &data, buffer_size_, timeout_msec);
+    }
+
+    template<typename T>
+    bool try_read(T& data, const int& timeout_msec = 0)
+    {
+        return read_range(0, &data, buffer_size_, timeout_msec);
+    }
+
+    bool try_write_range(const size_t& offset, const void* data, const size_t& length, const int& timeout_msec = 0)
+    {
+        check_range(offset, length);
+        return write_range(offset, data, length, timeout_msec);
+    }
+
+    bool try_read_range(const size_t& offset, void* data, const size_t& length, const int& timeout_msec = 0) const
+    {
+        check_range(offset, length);
+        return read_range(offset, data, length, timeout_msec);
+    }
+
+    template<typename T, typename M>
+    bool write_field(M T::* member, const M& value, const int& timeout_msec = 0)
+    {
+        return try_write_range(field_offset(member), &value, sizeof(M), timeout_msec);
+    }
+
+    template<typename T, typename M>
+    bool read_field(M T::* member, M& value, const int& timeout_msec = 0) const
+    {
+        return try_read_range(field_offset(member), &value, sizeof(M), timeout_msec);
+    }
+
+    template<typename T>
+    bool try_read_changed(T& data, uint32_t& version, const int& timeout_msec = 0) const
+    {
+        return read_changed(&data, version, timeout_msec);
+    }
+
+    uint32_t version() const
+    {
+        if(header_ == nullptr)
+            return 0;
+        return header_->sequence.load(std::memory_order_acquire) & ~1u;
+    }
+
+    bool wait_for_update(const uint32_t& last_version, const int& timeout_msec = 0) const
+    {
+        if(header_ == nullptr)
+        {
+            std::stringstream ss;
+            ss << "wait_for_update is not supported with SEMAPHORE lock type." << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+
+        // 待機者数を先に公開してからシーケンス番号を確認し、書込側の通知との行き違いを防ぐ。
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+        bool is_updated = true;
+        header_->waiters.fetch_add(1, std::memory_order_seq_cst);
+        while(true)
+        {
+            uint32_t current = header_->sequence.load(std::memory_order_acquire);
+            if((current & ~1u) != last_version)
+                break;
+            if(timeout_msec > 0 && std::chrono::steady_clock::now() > deadline)
+            {
+                is_updated = false;
+                break;
+            }
+            futex_wait(&header_->sequence, current, timeout_msec > 0 ? &deadline : nullptr);
+        }
+        header_->waiters.fetch_sub(1, std::memory_order_relaxed);
+        return is_updated;
+    }
+
+    bool sync(const bool& is_async = false)
+    {
+        if(!is_persistence_)
+            return true;
+#ifdef __unix__
+        last_sync_ = std::chrono::steady_clock::now();
+        return msync(mapping_, mapping_size_, is_async ? MS_ASYNC : MS_SYNC) == 0;
+#else
+        return true;
+#endif
+    }
+
+    Stats stats() const
+    {
+        Stats stats;
+        std::memset(&stats, 0, sizeof(Stats));
+        stats.lock_type   = lock_type_;
+        stats.buffer_size = buffer_size_;
+        stats.is_enabled  = (statistics_ != nullptr);
+        if(statistics_ != nullptr)
+            copy_stats(statistics_, stats);
+        stats.read_acquisitions = read_acquisitions_;
+        return stats;
+    }
+
+    void reset_stats()
+    {
+        read_acquisitions_ = 0;
+        if(statistics_ == nullptr)
+            return;
+        statistics_->acquisitions.store(0, std::memory_order_relaxed);
+        statistics_->contended.store(0, std::memory_order_relaxed);
+        statistics_->timeouts.store(0, std::memory_order_relaxed);
+        statistics_->total_wait_nsec.store(0, std::memory_order_relaxed);
+        statistics_->max_hold_nsec.store(0, std::memory_order_relaxed);
+        for(size_t i = 0; i < STATS_BUCKETS; i++)
+            statistics_->wait_histogram[i].store(0, std::memory_order_relaxed);
+    }
+
+    static bool read_stats(const void* mapping, const size_t& size, Stats& stats)
+    {
+        if(mapping == nullptr || size < sizeof(Header))
+            return false;
+        const Header* header = (const Header*)mapping;
+        if(header->magic.load(std::memory_order_acquire) != HEADER_MAGIC || header->lock_type > RW_LOCK)
+            return false;
+#ifdef __unix__
+        if(header->checksum != header_checksum(header))
+            return false;
+#endif
+        std::memset(&stats, 0, sizeof(Stats));
+        stats.lock_type   = (enum LockType)header->lock_type;
+        stats.buffer_size = header->buffer_size;
+        stats.is_enabled  = (header->statistics_enabled.load(std::memory_order_relaxed) != 0);
+        copy_stats(&header->statistics, stats);
+        return true;
+    }
+
+    uint64_t history_count() const { return (header_ == nullptr) ? 0 : header_->history_count.load(std::memory_order_acquire); }
+
+    template<typename T>
+    size_t try_read_history(uint64_t& since, T* data, const size_t& max_count, int64_t* timestamps = nullptr) const
+    {
+        check_range(0, sizeof(T));
+        return read_history(since, (char*)data, sizeof(T), max_count, timestamps);
+    }
+
+    template<typename T>
+    class ReadView final
+    {
+    private:
+        const SharedMemory* owner_;
+        const T* data_;
+        uint32_t ticket_;
+
+    public:
+        ReadView(const SharedMemory* owner, const int& timeout_msec)
+         :  owner_(owner), data_(nullptr), ticket_(0)
+        {
+            owner_->check_range(0, sizeof(T));
+            data_ = reinterpret_cast<const T*>(owner_->acquire_read(ticket_, timeout_msec));
+        }
+
+        ReadView(ReadView&& other)
+         :  owner_(other.owner_), data_(other.data_), ticket_(other.ticket_)
+        {
+            other.data_ = nullptr;
+        }
+
+        ReadView(const ReadView&) = delete;
+        ReadView& operator=(const ReadView&) = delete;
+
+        ~ReadView() { release(); }
+
+        explicit operator bool() const { return data_ != nullptr; }
+
+        const T& operator*() const { return *data_; }
+        const T* operator->() const { return data_; }
+
+        bool torn() const { return data_ == nullptr || !owner_->validate_read(reinterpret_cast<const char*>(data_), ticket_); }
+
+        void release()
+        {
+            if(data_ != nullptr)
+                owner_->release_read();
+            data_ = nullptr;
+        }
+    };
+
+    template<typename T>
+    class WriteView final
+    {
+    private:
+        SharedMemory* owner_;
+        T* data_;
+        uint32_t ticket_;
+
+    public:
+        WriteView(SharedMemory* owner, const int& timeout_msec)
+         :  owner_(owner), data_(nullptr), ticket_(0)
+        {
+            owner_->check_range(0, sizeof(T));
+            data_ = reinterpret_cast<T*>(owner_->acquire_write(ticket_, true, timeout_msec));
+        }
+
+        WriteView(WriteView&& other)
+         :  owner_(other.owner_), data_(other.data_), ticket_(other.ticket_)
+        {
+            other.data_ = nullptr;
+        }
+
+        WriteView(const WriteView&) = delete;
+        WriteView& operator=(const WriteView&) = delete;
+
+        ~WriteView() { release(); }
+
+        explicit operator bool() const { return data_ != nullptr; }
+
+        T& operator*() const { return *data_; }
+        T* operator->() const { return data_; }
+
+        void release()
+        {
+            if(data_ != nullptr)
+                owner_->release_write(ticket_, 0, owner_->buffer_size_);
+            data_ = nullptr;
+        }
+    };
+
+    template<typename T>
+    ReadView<T> read_view(const int& timeout_msec = 0) const
+    {
+        return ReadView<T>(this, timeout_msec);
+    }
+
+    template<typename T>
+    WriteView<T> write_view(const int& timeout_msec = 0)
+    {
+        return WriteView<T>(this, timeout_msec);
+    }
+
+    bool wait_for_single_object(const Handle& mutex_handle, const int& timeout_msec = 0) const
+    {
+        return lock_semaphore(mutex_handle, timeout_msec, true);
+    }
+
+    void release_mutex(const Handle& mutex_handle) const
+    {
+        unlock_semaphore(mutex_handle, true);
+    }
+
 };
 
 }
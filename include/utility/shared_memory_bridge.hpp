@@ -0,0 +1,402 @@
+/**
+ * @file shared_memory_bridge.hpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 共有メモリの内容を UDP で別ホストの共有メモリへ複製する @ref Utility::SharedMemoryBridge の定義ヘッダー
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _UTILITY_SHARED_MEMORY_BRIDGE_HPP_
+#define _UTILITY_SHARED_MEMORY_BRIDGE_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "utility/shared_memory.hpp"
+#include "utility/udp_socket.hpp"
+
+namespace Utility
+{
+
+/**
+ * @namespace Utility::SharedMemoryBridge
+ * @brief 共有メモリ→UDP→共有メモリの複製を行うクラス群
+ *
+ * @note 送信側は前回送信した内容と64バイト(キャッシュライン)単位で比較し、変化した範囲のみを送信する。
+ * @n 一定周期毎に全範囲を送るキーフレームを送信し、受信側はパケットの欠落を検出した場合、次のキーフレームまで反映を停止する。
+ * @n パケットはホストのバイトオーダーのまま送信するため、送受信ホストのエンディアンは一致していること。
+ *
+ * @example test/utility/shared_memory_bridge/test_shared_memory_bridge.cpp
+ */
+namespace SharedMemoryBridge
+{
+
+static constexpr uint32_t PACKET_MAGIC = 0x53484D42;    /**! "SHMB" */
+static constexpr uint16_t KEYFRAME     = 0x0001;        /**! キーフレームを示すフラグ */
+static constexpr size_t   LINE_SIZE    = 64;            /**! 差分を比較する単位 */
+
+/** パケット先頭のヘッダー */
+struct PacketHeader
+{
+    uint32_t magic;                                     /**! PACKET_MAGIC */
+    uint32_t sequence;                                  /**! パケット毎の通番 欠落検出に使用する */
+    uint32_t frame;                                     /**! 送信側の更新毎の通番 */
+    uint32_t size;                                      /**! 複製する構造体のサイズ */
+    uint16_t flags;                                     /**! KEYFRAME */
+    uint16_t range_count;                               /**! 後続する範囲の数 */
+    uint32_t fragment;                                  /**! フレーム内のパケット番号 */
+    uint32_t fragment_count;                            /**! フレームを構成するパケット数 */
+};
+
+/** ヘッダーに続く範囲情報 直後に length バイトのデータが続く */
+struct Range
+{
+    uint32_t offset;                                    /**! 構造体先頭からのオフセット */
+    uint32_t length;                                    /**! データ長 */
+};
+
+/**
+ * @class Sender
+ * @brief 共有メモリの更新差分を UDP で送信するクラス
+ *
+ * @tparam T 複製する構造体(memcpy でコピー可能な型に限る)
+ * @note 共有メモリ・ソケットは参照で保持するため、本インスタンスより長く生存させること。
+ * @n 送信先は UdpSocket::set_target_ports で事前に設定しておく。
+ */
+template<typename T>
+class Sender final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SharedMemoryBridge::Sender requires trivially copyable type.");
+    static_assert(sizeof(T) <= UINT32_MAX, "SharedMemoryBridge::Sender requires size representable by 32bit offset.");
+
+private:
+    SharedMemory& shmem_;
+    const UdpSocket& socket_;
+    size_t keyframe_interval_;
+    size_t packet_size_;
+    std::vector<char> current_;
+    std::vector<char> previous_;
+    std::vector<Range> ranges_;
+    std::vector<char> buffer_;
+    std::vector<size_t> packets_;
+    std::vector<uint16_t> range_counts_;
+    uint64_t cycle_;
+    uint32_t frame_;
+    uint32_t sequence_;
+    uint32_t version_;
+    uint64_t sent_packets_;
+    uint64_t sent_bytes_;
+
+    void collect(const bool& keyframe)
+    {
+        ranges_.clear();
+        for(size_t offset = 0; offset < sizeof(T); offset += LINE_SIZE)
+        {
+            size_t length = (sizeof(T) - offset < LINE_SIZE) ? sizeof(T) - offset : LINE_SIZE;
+            if(!keyframe && std::memcmp(current_.data() + offset, previous_.data() + offset, length) == 0)
+                continue;
+            if(!ranges_.empty() && ranges_.back().offset + ranges_.back().length == offset)
+                ranges_.back().length += length;
+            else
+                ranges_.push_back(Range{ (uint32_t)offset, (uint32_t)length });
+        }
+    }
+
+    void begin_packet()
+    {
+        packets_.push_back(buffer_.size());
+        range_counts_.push_back(0);
+        buffer_.resize(buffer_.size() + sizeof(PacketHeader));
+    }
+
+    bool send(const bool& keyframe)
+    {
+        buffer_.clear();
+        packets_.clear();
+        range_counts_.clear();
+        begin_packet();
+        for(const auto& range : ranges_)
+        {
+            uint32_t offset = range.offset;
+            uint32_t remain = range.length;
+            while(remain > 0)
+            {
+                size_t used = buffer_.size() - packets_.back();
+                if(packet_size_ - used <= sizeof(Range))
+                {
+                    begin_packet();
+                    used = sizeof(PacketHeader);
+                }
+                uint32_t length = (remain < packet_size_ - used - sizeof(Range)) ? remain : (uint32_t)(packet_size_ - used - sizeof(Range));
+                Range chunk = { offset, length };
+                size_t position = buffer_.size();
+                buffer_.resize(position + sizeof(Range) + length);
+                std::memcpy(buffer_.data() + position, &chunk, sizeof(Range));
+                std::memcpy(buffer_.data() + position + sizeof(Range), current_.data() + offset, length);
+                range_counts_.back()++;
+                offset += length;
+                remain -= length;
+            }
+        }
+
+        bool result = true;
+        for(size_t i = 0; i < packets_.size(); i++)
+        {
+            size_t begin = packets_[i];
+            size_t end   = (i + 1 < packets_.size()) ? packets_[i + 1] : buffer_.size();
+            PacketHeader header = { PACKET_MAGIC, sequence_++, frame_, (uint32_t)sizeof(T), (uint16_t)(keyframe ? KEYFRAME : 0), range_counts_[i], (uint32_t)i, (uint32_t)packets_.size() };
+            std::memcpy(buffer_.data() + begin, &header, sizeof(PacketHeader));
+            // 送信に失敗しても通番は進めるため、受信側は欠落として扱い次のキーフレームで回復する。
+            if(socket_.try_write(buffer_.data() + begin, (int)(end - begin)))
+            {
+                sent_packets_++;
+                sent_bytes_ += end - begin;
+            }
+            else
+                result = false;
+        }
+        return result;
+    }
+
+public:
+
+    /**
+     * @fn Sender
+     * @brief コンストラクタ
+     *
+     * @param SharedMemory shmem 複製元の共有メモリ
+     * @param UdpSocket socket 送信に使用するソケット
+     * @param size_t keyframe_interval キーフレームを送信する update の呼出周期(省略可能)
+     * @param size_t packet_size 1パケットの最大サイズ(省略可能) 経路の MTU を超えない値を指定する。
+     */
+    Sender(SharedMemory& shmem, const UdpSocket& socket, const size_t& keyframe_interval = 100, const size_t& packet_size = 1400)
+     :  shmem_(shmem), socket_(socket),
+        keyframe_interval_(keyframe_interval == 0 ? 1 : keyframe_interval), packet_size_(packet_size),
+        current_(sizeof(T)), previous_(sizeof(T)),
+        cycle_(0), frame_(0), sequence_(0), version_(0), sent_packets_(0), sent_bytes_(0)
+    {
+        if(packet_size_ <= sizeof(PacketHeader) + sizeof(Range) || packet_size_ > 65507)
+        {
+            std::stringstream ss;
+            ss << "invalid bridge packet size." << std::endl;
+            ss << "packet size : " << packet_size_ << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+    /**
+     * @fn update
+     * @brief 共有メモリを読み込み、前回送信時からの差分を送信する。
+     *
+     * @param int timeout_msec 共有メモリ読込のタイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+     * @return true  送信成功 又は変化がなく送信不要
+     * @return false 共有メモリの読込失敗 又は送信失敗
+     * @note 周期処理で呼び出す。SEMAPHORE 以外の排他制御方式では更新番号が変化していなければ読込自体を省略する。
+     */
+    bool update(const int& timeout_msec = 0)
+    {
+        bool keyframe = (cycle_++ % keyframe_interval_ == 0);
+        if(!keyframe && shmem_.lock_type() != SharedMemory::SEMAPHORE && shmem_.version() == version_)
+            return true;
+
+        uint32_t version = shmem_.version();
+        if(!shmem_.try_read_range(0, current_.data(), sizeof(T), timeout_msec))
+            return false;
+        version_ = version;
+
+        collect(keyframe);
+        if(ranges_.empty())
+            return true;
+        bool result = send(keyframe);
+        current_.swap(previous_);
+        frame_++;
+        return result;
+    }
+
+    /**
+     * @fn sent_packets
+     * @brief 送信したパケット数の累計の取得
+     */
+    uint64_t sent_packets() const { return sent_packets_; }
+
+    /**
+     * @fn sent_bytes
+     * @brief 送信したバイト数の累計の取得
+     */
+    uint64_t sent_bytes() const { return sent_bytes_; }
+
+    /**
+     * @fn frame
+     * @brief 送信したフレーム数の取得
+     */
+    uint32_t frame() const { return frame_; }
+};
+
+/**
+ * @class Receiver
+ * @brief UDP で受信した差分を共有メモリへ反映するクラス
+ *
+ * @tparam T 複製する構造体(送信側と同じ型)
+ * @note 共有メモリ・ソケットは参照で保持するため、本インスタンスより長く生存させること。
+ * @n 受信ポートは UdpSocket::set_listen_port で事前に設定しておく。受信待ちの上限は UdpSocket::set_timeout で設定する。
+ * @n 1フレームを構成する全パケットを受信した時点で、変化した範囲をまとめて1回の try_write_range で反映する。
+ */
+template<typename T>
+class Receiver final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SharedMemoryBridge::Receiver requires trivially copyable type.");
+
+private:
+    SharedMemory& shmem_;
+    const UdpSocket& socket_;
+    std::vector<char> mirror_;
+    std::vector<char> buffer_;
+    bool received_;
+    bool synced_;
+    bool frame_valid_;
+    uint32_t sequence_;
+    uint32_t frame_;
+    uint32_t next_fragment_;
+    uint64_t received_packets_;
+    size_t lower_;
+    size_t upper_;
+    uint64_t lost_;
+    uint64_t invalid_;
+
+public:
+
+    /**
+     * @fn Receiver
+     * @brief コンストラクタ
+     *
+     * @param SharedMemory shmem 複製先の共有メモリ
+     * @param UdpSocket socket 受信に使用するソケット
+     */
+    Receiver(SharedMemory& shmem, const UdpSocket& socket)
+     :  shmem_(shmem), socket_(socket), mirror_(sizeof(T)), buffer_(65507),
+        received_(false), synced_(false), frame_valid_(false),
+        sequence_(0), frame_(0), next_fragment_(0), received_packets_(0), lower_(0), upper_(0), lost_(0), invalid_(0)
+    {}
+
+    /**
+     * @fn update
+     * @brief 1パケットを受信し、フレームが揃った場合は共有メモリへ反映する。
+     *
+     * @param int timeout_msec 共有メモリ書込のタイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+     * @return true  共有メモリへ反映した
+     * @return false 受信失敗、フレームの途中、又は欠落によりキーフレーム待ちの状態
+     */
+    bool update(const int& timeout_msec = 0)
+    {
+        int length;
+        if(!socket_.try_read_datagram(buffer_.data(), (int)buffer_.size(), length))
+            return false;
+
+        received_packets_++;
+        PacketHeader header;
+        if((size_t)length < sizeof(PacketHeader))
+        {
+            invalid_++;
+            return false;
+        }
+        std::memcpy(&header, buffer_.data(), sizeof(PacketHeader));
+        if(header.magic != PACKET_MAGIC || header.size != sizeof(T))
+        {
+            invalid_++;
+            return false;
+        }
+
+        if(received_)
+        {
+            int32_t gap = (int32_t)(header.sequence - sequence_);
+            if(gap <= 0)
+                return false;                           // 重複又は順序が入れ替わったパケットは破棄する。
+            if(gap > 1)
+            {
+                lost_ += gap - 1;
+                synced_ = false;
+                frame_valid_ = false;
+            }
+        }
+        received_ = true;
+        sequence_ = header.sequence;
+
+        if(header.fragment == 0)
+        {
+            frame_       = header.frame;
+            frame_valid_ = true;
+            lower_       = sizeof(T);
+            upper_       = 0;
+        }
+        else if(header.frame != frame_ || header.fragment != next_fragment_)
+            frame_valid_ = false;
+        next_fragment_ = header.fragment + 1;
+
+        size_t position = sizeof(PacketHeader);
+        for(uint16_t i = 0; i < header.range_count; i++)
+        {
+            Range range;
+            if(position + sizeof(Range) > (size_t)length)
+                break;
+            std::memcpy(&range, buffer_.data() + position, sizeof(Range));
+            position += sizeof(Range);
+            if(range.offset > sizeof(T) || range.length > sizeof(T) - range.offset || position + range.length > (size_t)length)
+            {
+                invalid_++;
+                frame_valid_ = false;
+                return false;
+            }
+            std::memcpy(mirror_.data() + range.offset, buffer_.data() + position, range.length);
+            position += range.length;
+            if(range.offset < lower_)
+                lower_ = range.offset;
+            if(range.offset + range.length > upper_)
+                upper_ = range.offset + range.length;
+        }
+
+        if(header.fragment + 1 != header.fragment_count || !frame_valid_)
+            return false;
+        if(header.flags & KEYFRAME)
+            synced_ = true;
+        if(!synced_ || upper_ <= lower_)
+            return false;
+        return shmem_.try_write_range(lower_, mirror_.data() + lower_, upper_ - lower_, timeout_msec);
+    }
+
+    /**
+     * @fn synced
+     * @brief 送信側と同期済みかどうかの判定 欠落を検出してから次のキーフレームを受信するまでは false となる。
+     */
+    bool synced() const { return synced_; }
+
+    /**
+     * @fn received_packets
+     * @brief 受信したパケット数の累計の取得
+     */
+    uint64_t received_packets() const { return received_packets_; }
+
+    /**
+     * @fn lost
+     * @brief 欠落したパケット数の累計の取得
+     */
+    uint64_t lost() const { return lost_; }
+
+    /**
+     * @fn invalid
+     * @brief 形式不正として破棄したパケット数の累計の取得
+     */
+    uint64_t invalid() const { return invalid_; }
+};
+
+}
+
+}
+
+#endif // _UTILITY_SHARED_MEMORY_BRIDGE_HPP_
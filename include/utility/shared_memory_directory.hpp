@@ -0,0 +1,519 @@
+/**
+ * @file shared_memory_directory.hpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 1つの共有メモリ上に名前付きの複数チャネルを配置する @ref Utility::SharedMemoryDirectory クラスの定義ヘッダー
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _UTILITY_SHARED_MEMORY_DIRECTORY_HPP_
+#define _UTILITY_SHARED_MEMORY_DIRECTORY_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <typeinfo>
+#include <type_traits>
+#include <vector>
+
+#ifdef __unix__
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+#include "utility/shared_memory.hpp"
+
+namespace Utility
+{
+
+/**
+ * @class Utility::SharedMemoryDirectory
+ * @brief 1つの共有メモリを名前付きの複数チャネルに分割して使用するクラス
+ *
+ * @note 共有メモリ先頭に名前・オフセット・サイズ・型識別子を持つ登録表を配置し、後方の領域をチャネル毎に割り当てる。
+ * @n 構造体毎に @ref Utility::SharedMemory を生成する場合と異なり、共有メモリは1つしか生成しない。
+ * @n 共有メモリは SharedMemory::NONE で生成するため、セマフォは生成しない。
+ * @n 各チャネルは専用のシーケンス番号で排他制御(シーケンスロック)を行う。
+ * @n 複数チャネルを同時に更新する場合は @ref Transaction を使用する。ディレクトリ共通のエポック番号で公開をまとめ、
+ * @n 読込側は @ref read_consistent で全チャネルが同一トランザクション境界にある組を読み取れる。
+ * @n チャネルの登録は追加のみで、削除はできない。
+ * @n チャネルの登録表はスピンロックで排他し、ロック変数に保持プロセスの ID を格納する。保持したまま異常終了したプロセスのロックは、
+ * @n 待機中の他プロセスが kill(pid, 0) で終了を検出して引き継ぐ。このため接続する全プロセスが同じ PID 名前空間にあることを前提とする(Windows では引き継がない)。
+ * @n 型識別子は typeid(T).name() から生成するため、同じコンパイラ・ABI でビルドしたプロセス間でのみ同じ型を同じ識別子として扱う。
+ *
+ * @example test/utility/shared_memory_directory/test_shared_memory_directory.cpp
+ */
+class SharedMemoryDirectory final
+{
+private:
+    static constexpr size_t NAME_SIZE = 40;
+
+    /** 共有メモリ先頭に配置する管理領域 */
+    struct alignas(64) Control
+    {
+        std::atomic<uint32_t> state;                    /**! 0:未初期化 1:初期化中 2:初期化完了 */
+        std::atomic<uint32_t> lock;                     /**! チャネル登録時のスピンロック 0:解放 それ以外:保持しているプロセスの ID */
+        std::atomic<uint32_t> count;                    /**! 登録済みチャネル数 */
+        uint32_t capacity;                              /**! 登録表の要素数 */
+        uint64_t arena_size;                            /**! チャネルに割り当てる領域のサイズ */
+        uint64_t used;                                  /**! 割当済みの領域のサイズ */
+        alignas(64) std::atomic<uint32_t> epoch;        /**! トランザクション公開用のシーケンス番号 奇数の間は公開中 */
+    };
+
+    /** 登録表の1要素 */
+    struct alignas(64) Entry
+    {
+        std::atomic<uint32_t> state;                    /**! 0:未登録 1:登録済み */
+        uint32_t type_hash;                             /**! 型識別子 */
+        uint64_t offset;                                /**! 割当領域先頭からのオフセット */
+        uint64_t size;                                  /**! 構造体のサイズ */
+        char name[NAME_SIZE];                           /**! チャネル名 */
+    };
+
+    /** チャネル毎の割当領域先頭に配置する排他制御用シーケンス番号 */
+    struct alignas(64) Sequence
+    {
+        std::atomic<uint32_t> value;                    /**! 奇数の間は書込中 */
+    };
+
+    SharedMemory shmem_;
+    Control* control_;
+    Entry* entries_;
+    char* arena_;
+
+    static size_t round_up(const size_t& size)
+    {
+        return (size + 63) / 64 * 64;
+    }
+
+    template<typename T>
+    static uint32_t type_hash()
+    {
+        // 型名(コンパイラ依存)とサイズから FNV-1a で識別子を生成する。
+        // 型名の表記はコンパイラ・ABI 毎に異なるため、異なるコンパイラでビルドしたプロセス間では同じ型でも一致しない。
+        const char* name = typeid(T).name();
+        uint32_t hash = 2166136261u;
+        for(size_t i = 0; name[i] != '\0'; i++)
+            hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+        return (hash ^ (uint32_t)sizeof(T)) * 16777619u;
+    }
+
+    void initialize(const size_t& capacity, const size_t& arena_size)
+    {
+        uint32_t expected = 0;
+        if(control_->state.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+        {
+            control_->capacity   = capacity;
+            control_->arena_size = arena_size;
+            control_->used       = 0;
+            control_->state.store(2, std::memory_order_release);
+            return;
+        }
+        while(control_->state.load(std::memory_order_acquire) != 2)
+            std::this_thread::yield();
+        if(control_->capacity != capacity || control_->arena_size != arena_size)
+        {
+            std::stringstream ss;
+            ss << "shared memory directory layout mismatch." << std::endl;
+            ss << "capacity : " << control_->capacity << " arena size : " << control_->arena_size << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+    }
+
+    static bool begin_sequence(std::atomic<uint32_t>& value, uint32_t& sequence, const int& timeout_msec)
+    {
+        auto end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+        sequence = value.load(std::memory_order_relaxed);
+        while((sequence & 1) || !value.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            if(timeout_msec > 0 && std::chrono::steady_clock::now() > end_time)
+                return false;
+            std::this_thread::yield();
+            sequence = value.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    static void end_sequence(std::atomic<uint32_t>& value, const uint32_t& sequence)
+    {
+        value.store(sequence + 2, std::memory_order_release);
+    }
+
+    static uint32_t process_id()
+    {
+#ifdef __unix__
+        return (uint32_t)getpid();
+#else
+        return 1;
+#endif
+    }
+
+    static bool is_alive(const uint32_t& pid)
+    {
+#ifdef __unix__
+        return kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+#else
+        return true;
+#endif
+    }
+
+    void lock_table()
+    {
+        // 保持したまま異常終了したプロセスのロックを引き継ぎ、以降の channel 呼出が全プロセスで止まることを防ぐ。
+        // attach は登録済みチャネル数の更新を最後に行うため、途中で終了した登録は次の登録で上書きされる。
+        static constexpr int CHECK_INTERVAL = 1000;
+        uint32_t self = process_id();
+        int retry = 0;
+        while(true)
+        {
+            uint32_t owner = 0;
+            if(control_->lock.compare_exchange_weak(owner, self, std::memory_order_acquire))
+                return;
+            if(owner != 0 && ++retry % CHECK_INTERVAL == 0 && !is_alive(owner)
+                && control_->lock.compare_exchange_strong(owner, self, std::memory_order_acquire))
+                return;
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock_table()
+    {
+        control_->lock.store(0, std::memory_order_release);
+    }
+
+    Entry* find(const char* name) const
+    {
+        uint32_t count = control_->count.load(std::memory_order_acquire);
+        for(uint32_t i = 0; i < count; i++)
+            if(entries_[i].state.load(std::memory_order_acquire) == 1 && std::strncmp(entries_[i].name, name, NAME_SIZE) == 0)
+                return &entries_[i];
+        return nullptr;
+    }
+
+    Entry* attach(const char* name, const uint32_t& hash, const size_t& size)
+    {
+        if(std::strlen(name) >= NAME_SIZE)
+        {
+            std::stringstream ss;
+            ss << "channel name is too long." << std::endl;
+            ss << "name : " << name << " max length : " << NAME_SIZE - 1 << std::endl;
+            throw std::runtime_error(ss.str());
+        }
+
+        lock_table();
+        Entry* entry = find(name);
+        std::stringstream ss;
+        if(entry == nullptr)
+        {
+            uint32_t count = control_->count.load(std::memory_order_relaxed);
+            size_t block   = sizeof(Sequence) + round_up(size);
+            if(count >= control_->capacity)
+                ss << "shared memory directory is full." << std::endl << "capacity : " << control_->capacity << std::endl;
+            else if(control_->used + block > control_->arena_size)
+                ss << "shared memory directory has no space." << std::endl << "required : " << block << " remain : " << control_->arena_size - control_->used << std::endl;
+            else
+            {
+                entry = &entries_[count];
+                std::memset(arena_ + control_->used, 0, block);
+                entry->type_hash = hash;
+                entry->offset    = control_->used;
+                entry->size      = size;
+                std::strncpy(entry->name, name, NAME_SIZE);
+                entry->state.store(1, std::memory_order_release);
+                control_->used += block;
+                control_->count.store(count + 1, std::memory_order_release);
+            }
+        }
+        else if(entry->type_hash != hash || entry->size != size)
+        {
+            ss << "channel type mismatch." << std::endl;
+            ss << "name : " << name << " size : " << entry->size << " required size : " << size << std::endl;
+            entry = nullptr;
+        }
+        unlock_table();
+
+        if(entry == nullptr)
+            throw std::runtime_error(ss.str());
+        return entry;
+    }
+
+public:
+
+    class Transaction;
+
+    /**
+     * @class Channel
+     * @brief ディレクトリ上の1チャネルに対する型付きハンドル
+     *
+     * @tparam T チャネルでやりとりする構造体(memcpy でコピー可能な型に限る)
+     * @note ハンドルは生成元の @ref Utility::SharedMemoryDirectory より長く使用してはならない。
+     */
+    template<typename T>
+    class Channel final
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SharedMemoryDirectory::Channel requires trivially copyable type.");
+
+    private:
+        friend class Transaction;
+
+        Sequence* sequence_;
+        T* data_;
+
+    public:
+        Channel(Sequence* sequence, T* data)
+         :  sequence_(sequence), data_(data)
+        {}
+
+        /**
+         * @fn try_write
+         * @brief ローカル変数->チャネルへの書込試行処理
+         *
+         * @param T data 書き込む構造体変数
+         * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+         * @return true  書込成功
+         * @return false 書込失敗
+         */
+        bool try_write(const T& data, const int& timeout_msec = 0)
+        {
+            uint32_t sequence;
+            if(!begin_sequence(sequence_->value, sequence, timeout_msec))
+                return false;
+            std::memcpy(data_, &data, sizeof(T));
+            end_sequence(sequence_->value, sequence);
+            return true;
+        }
+
+        /**
+         * @fn try_read
+         * @brief チャネル→ローカル変数の読取試行処理
+         *
+         * @param T data 読み取る構造体変数
+         * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+         * @return true  読取成功
+         * @return false 読取失敗 data の内容は不定となる。
+         */
+        bool try_read(T& data, const int& timeout_msec = 0) const
+        {
+            auto end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+            while(true)
+            {
+                uint32_t before = sequence_->value.load(std::memory_order_acquire);
+                if((before & 1) == 0)
+                {
+                    std::memcpy(&data, data_, sizeof(T));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if(sequence_->value.load(std::memory_order_relaxed) == before)
+                        return true;
+                }
+                if(timeout_msec > 0 && std::chrono::steady_clock::now() > end_time)
+                    return false;
+                std::this_thread::yield();
+            }
+        }
+
+        /**
+         * @fn version
+         * @brief 最後に公開された書込の更新番号の取得
+         */
+        uint32_t version() const { return sequence_->value.load(std::memory_order_acquire) & ~1u; }
+    };
+
+    /**
+     * @class Transaction
+     * @brief 複数チャネルへの書込をまとめて公開するトランザクション
+     *
+     * @note @ref write でローカルのバッファに書込内容を溜め、@ref commit でディレクトリのエポック番号を1回だけ取得して全チャネルへ反映する。
+     * @n 反映中は各チャネルのシーケンス番号も奇数となるため、単一チャネルの try_read は従来通り整合した値を読み取る。
+     * @n commit 後はバッファを空にするため、同じインスタンスを周期処理で使い回すことで動的確保を避けられる。
+     * @n 1つのインスタンスを複数スレッドから同時に使用してはならない。
+     */
+    class Transaction final
+    {
+    private:
+        struct Staged
+        {
+            std::atomic<uint32_t>* sequence;
+            char* destination;
+            size_t offset;
+            size_t size;
+        };
+
+        Control* control_;
+        std::vector<Staged> staged_;
+        std::vector<char> buffer_;
+
+    public:
+        explicit Transaction(SharedMemoryDirectory& directory)
+         :  control_(directory.control_)
+        {}
+
+        /**
+         * @fn write
+         * @brief チャネルへの書込内容をトランザクションに追加する。
+         *
+         * @param Channel<T> channel 書込先のチャネル
+         * @param T data 書き込む構造体変数
+         * @note 共有メモリへの反映は @ref commit 呼出時に行う。同じチャネルに複数回書き込んだ場合は順に反映され、最後の値が残る。
+         */
+        template<typename T>
+        void write(const Channel<T>& channel, const T& data)
+        {
+            Staged staged = { &channel.sequence_->value, reinterpret_cast<char*>(channel.data_), buffer_.size(), sizeof(T) };
+            buffer_.resize(buffer_.size() + sizeof(T));
+            std::memcpy(buffer_.data() + staged.offset, &data, sizeof(T));
+            staged_.push_back(staged);
+        }
+
+        /**
+         * @fn commit
+         * @brief 溜めた書込内容を共有メモリへまとめて公開する。
+         *
+         * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+         * @return true  公開成功
+         * @return false 公開失敗 他のトランザクションが公開中のままタイムアウトした。書込内容は保持される。
+         * @note タイムアウトはエポック番号の取得にのみ適用する。各チャネルの書込は短時間で完了するため待機し続ける。
+         */
+        bool commit(const int& timeout_msec = 0)
+        {
+            uint32_t epoch;
+            if(!begin_sequence(control_->epoch, epoch, timeout_msec))
+                return false;
+            for(const auto& staged : staged_)
+            {
+                uint32_t sequence;
+                begin_sequence(*staged.sequence, sequence, 0);
+                std::memcpy(staged.destination, buffer_.data() + staged.offset, staged.size);
+                end_sequence(*staged.sequence, sequence);
+            }
+            end_sequence(control_->epoch, epoch);
+            clear();
+            return true;
+        }
+
+        /**
+         * @fn clear
+         * @brief 溜めた書込内容を公開せずに破棄する。
+         */
+        void clear()
+        {
+            staged_.clear();
+            buffer_.clear();
+        }
+
+        /**
+         * @fn empty
+         * @brief 未公開の書込内容がないかどうかの判定
+         */
+        bool empty() const { return staged_.empty(); }
+    };
+
+    /**
+     * @fn SharedMemoryDirectory
+     * @brief コンストラクタ
+     *
+     * @param const char* shmem_name 共有メモリ名
+     * @param size_t arena_size チャネルに割り当てる領域の合計サイズ
+     * @param size_t capacity 登録できるチャネル数(省略可能)
+     * @param MapOption option マッピングオプション(省略可能)
+     * @note 各チャネルは構造体サイズを64バイト単位に切り上げ、シーケンス番号用の64バイトを加えた領域を使用する。
+     * @n 同名の共有メモリを異なる arena_size, capacity で生成済みの場合は例外を送出する。
+     */
+    SharedMemoryDirectory(const char* shmem_name, const size_t& arena_size, const size_t& capacity = 64, const SharedMemory::MapOption& option = SharedMemory::MapOption())
+     :  shmem_(shmem_name, sizeof(Control) + capacity * sizeof(Entry) + round_up(arena_size), SharedMemory::NONE, option),
+        control_(shmem_.get<Control>()),
+        entries_(reinterpret_cast<Entry*>(shmem_.get<char>() + sizeof(Control))),
+        arena_(shmem_.get<char>() + sizeof(Control) + capacity * sizeof(Entry))
+    {
+        initialize(capacity, round_up(arena_size));
+    }
+
+    SharedMemoryDirectory(const SharedMemoryDirectory&) = delete;
+    SharedMemoryDirectory& operator=(const SharedMemoryDirectory&) = delete;
+
+    /**
+     * @fn channel
+     * @brief 名前を指定してチャネルを取得する。未登録の場合は登録する。
+     *
+     * @tparam T チャネルでやりとりする構造体
+     * @param const char* name チャネル名(39文字以内)
+     * @return Channel<T> チャネルの型付きハンドル
+     * @note 名前の検索は本メソッド呼出時のみ行うため、周期処理では戻り値を保持して使用する。
+     * @n 同名のチャネルが異なる型で登録済みの場合、又は領域・登録表が不足する場合は例外を送出する。
+     * @n 型の一致は typeid(T).name() で判定するため、異なるコンパイラ・ABI でビルドしたプロセス間では同じ型でも例外となる。
+     */
+    template<typename T>
+    Channel<T> channel(const char* name)
+    {
+        Entry* entry = attach(name, type_hash<T>(), sizeof(T));
+        char* block  = arena_ + entry->offset;
+        return Channel<T>(reinterpret_cast<Sequence*>(block), reinterpret_cast<T*>(block + sizeof(Sequence)));
+    }
+
+    /**
+     * @fn read_consistent
+     * @brief トランザクション境界で整合した複数チャネルの読込処理
+     *
+     * @param Function function チャネルの try_read を行う関数オブジェクト
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+     * @return true  読込成功 function 内で読み取った値は全て同一のエポック番号の間に公開されたものである。
+     * @return false 読込失敗 読み取った値の組は不定となる。
+     * @note 読込中にトランザクションが公開された場合は function を再実行するため、function は副作用を持たないこと。
+     * @n トランザクションを経由しない try_write による更新は検出しない。
+     */
+    template<typename Function>
+    bool read_consistent(Function function, const int& timeout_msec = 0) const
+    {
+        auto end_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+        while(true)
+        {
+            uint32_t before = control_->epoch.load(std::memory_order_acquire);
+            if((before & 1) == 0)
+            {
+                function();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(control_->epoch.load(std::memory_order_relaxed) == before)
+                    return true;
+            }
+            if(timeout_msec > 0 && std::chrono::steady_clock::now() > end_time)
+                return false;
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * @fn epoch
+     * @brief 最後に公開されたトランザクションの番号の取得
+     */
+    uint32_t epoch() const { return control_->epoch.load(std::memory_order_acquire) & ~1u; }
+
+    /**
+     * @fn contains
+     * @brief 指定した名前のチャネルが登録済みかどうかの判定
+     */
+    bool contains(const char* name) const { return find(name) != nullptr; }
+
+    /**
+     * @fn size
+     * @brief 登録済みチャネル数の取得
+     */
+    size_t size() const { return control_->count.load(std::memory_order_acquire); }
+
+    /**
+     * @fn capacity
+     * @brief 登録できるチャネル数の取得
+     */
+    size_t capacity() const { return control_->capacity; }
+};
+
+}
+
+#endif // _UTILITY_SHARED_MEMORY_DIRECTORY_HPP_
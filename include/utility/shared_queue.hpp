@@ -0,0 +1,323 @@
+/**
+ * @file shared_queue.hpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 共有メモリ上で複数プロセス間のメッセージキューを構成する @ref Utility::SharedQueue クラスの定義ヘッダー
+ * @note 本クラス作成にあたって参考にしたリンク集
+ * @n スロット毎のシーケンス番号による有界MPMCキュー関連 @link https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue @endlink
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _UTILITY_SHARED_QUEUE_HPP_
+#define _UTILITY_SHARED_QUEUE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "utility/shared_memory.hpp"
+
+namespace Utility
+{
+
+/**
+ * @class Utility::SharedQueue
+ * @brief 共有メモリ上の有界キューによる複数生産者・複数消費者キュー
+ *
+ * @tparam T キューでやりとりする構造体(memcpy でコピー可能な型に限る)
+ * @note 各スロットにシーケンス番号を持たせ、書込位置・読込位置の CAS のみで排他する。
+ * @n セマフォを使用しないため、書込側が増えても1つのロックに集中しない。
+ * @n 各スロットはキャッシュライン境界に配置し、隣接スロットを扱うプロセス同士の偽共有を避ける。
+ * @n push / pop で待機する場合は futex で休止し、相手側の try_push / try_pop で起床する。待機者がいない場合は起床のシステムコールを発行しない。
+ *
+ * @example test/utility/shared_queue/test_shared_queue.cpp
+ */
+template<typename T>
+class SharedQueue final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SharedQueue requires trivially copyable type.");
+
+private:
+    /** 共有メモリ先頭に配置する初期化状態・書込位置・読込位置 */
+    struct Control
+    {
+        alignas(64) std::atomic<uint32_t> state;        /**! 0:未初期化 1:初期化中 2:初期化完了 */
+        alignas(64) std::atomic<uint64_t> enqueue_pos;  /**! 次の書込位置 */
+        alignas(64) std::atomic<uint64_t> dequeue_pos;  /**! 次の読込位置 */
+        alignas(64) std::atomic<uint32_t> enqueue_event;    /**! 読込側の待機中に書き込んだ場合に進める番号(futex で待機する) */
+        std::atomic<uint32_t> dequeue_event;                /**! 書込側の待機中に読み込んだ場合に進める番号(futex で待機する) */
+        std::atomic<uint32_t> enqueue_waiters;              /**! 空き待ちの書込側の数 */
+        std::atomic<uint32_t> dequeue_waiters;              /**! 要素待ちの読込側の数 */
+    };
+
+    /** 1要素分のスロット */
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> sequence;                 /**! 書込可能: 位置と一致 読込可能: 位置+1 と一致 */
+        T data;
+    };
+
+    uint64_t capacity_;
+    uint64_t mask_;
+    SharedMemory shmem_;
+    Control* control_;
+    Slot* slots_;
+
+    static uint64_t round_up(const size_t& capacity)
+    {
+        uint64_t result = 1;
+        while(result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+    void initialize()
+    {
+        uint32_t expected = 0;
+        if(control_->state.compare_exchange_strong(expected, 1, std::memory_order_acquire))
+        {
+            for(uint64_t i = 0; i < capacity_; i++)
+                slots_[i].sequence.store(i, std::memory_order_relaxed);
+            control_->state.store(2, std::memory_order_release);
+            return;
+        }
+        // 生成側プロセスが初期化中に終了した場合に待ち続けないよう、SharedMemory のヘッダー待ちと同様に時間を区切る。
+        auto end_time = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        while(control_->state.load(std::memory_order_acquire) != 2)
+        {
+            if(std::chrono::steady_clock::now() > end_time)
+                throw std::runtime_error("shared queue is not initialized. the creating process may have exited during initialization.");
+            std::this_thread::yield();
+        }
+    }
+
+    /** 相手側が待機中の場合のみ event を進めて起床させる。 */
+    static void notify(std::atomic<uint32_t>& event, const std::atomic<uint32_t>& waiters)
+    {
+        // スロットの公開と待機者数の読込の順序を保証するため、間に完全なフェンスを挟む。
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(waiters.load(std::memory_order_relaxed) == 0)
+            return;
+        event.fetch_add(1, std::memory_order_release);
+        SharedMemory::futex_wake(&event, INT_MAX);
+    }
+
+    /** try_once が成功するまで、event が進むのを futex で待機する。 */
+    template<typename F>
+    static bool wait(const F& try_once, std::atomic<uint32_t>& event, std::atomic<uint32_t>& waiters, const int& timeout_msec)
+    {
+        if(try_once())
+            return true;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_msec);
+        while(true)
+        {
+            // 待機者数を先に公開してから再試行し、相手側の通知との行き違いを防ぐ。
+            waiters.fetch_add(1, std::memory_order_seq_cst);
+            uint32_t current = event.load(std::memory_order_acquire);
+            bool is_done     = try_once();
+            bool is_timeout  = !is_done && timeout_msec > 0 && std::chrono::steady_clock::now() > deadline;
+            if(!is_done && !is_timeout)
+                SharedMemory::futex_wait(&event, current, (timeout_msec > 0) ? &deadline : nullptr);
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+            if(is_done)
+                return true;
+            if(is_timeout)
+                return false;
+        }
+    }
+
+public:
+
+    /**
+     * @fn SharedQueue
+     * @brief コンストラクタ
+     *
+     * @param const char* shmem_name 共有メモリ名
+     * @param size_t capacity キューに格納できる要素数 2のべき乗に切り上げられる。
+     * @note 同名の共有メモリが異なる要素数・要素サイズで生成済みの場合は例外を送出する。
+     * @n 生成側プロセスの初期化が1秒以内に完了しない場合(初期化中に異常終了した場合等)も例外を送出する。
+     */
+    SharedQueue(const char* shmem_name, const size_t& capacity)
+     :  capacity_(round_up(capacity < 2 ? 2 : capacity)),
+        mask_(capacity_ - 1),
+        shmem_(shmem_name, sizeof(Control) + capacity_ * sizeof(Slot), SharedMemory::NONE),
+        control_(shmem_.get<Control>()),
+        slots_(reinterpret_cast<Slot*>(shmem_.get<char>() + sizeof(Control)))
+    {
+        initialize();
+    }
+
+    SharedQueue(const SharedQueue&) = delete;
+    SharedQueue& operator=(const SharedQueue&) = delete;
+
+    /**
+     * @fn try_push
+     * @brief 1要素の書込試行処理
+     *
+     * @param T data 書き込む構造体変数
+     * @return true  書込成功
+     * @return false キューが満杯のため書込失敗
+     */
+    bool try_push(const T& data)
+    {
+        return try_push(&data, 1) == 1;
+    }
+
+    /**
+     * @fn try_push
+     * @brief 複数要素の一括書込試行処理
+     *
+     * @param T* data 書き込む構造体配列の先頭ポインタ
+     * @param size_t count 書き込む最大要素数
+     * @return size_t 実際に書き込んだ要素数
+     * @note 連続して書込可能なスロット分の書込位置を1回の CAS でまとめて確保する。
+     */
+    size_t try_push(const T* data, const size_t& count)
+    {
+        uint64_t pos = control_->enqueue_pos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            size_t n = 0;
+            while(n < count && n < capacity_ && slots_[(pos + n) & mask_].sequence.load(std::memory_order_acquire) == pos + n)
+                n++;
+            if(n == 0)
+            {
+                // 先頭スロットが読込待ちの場合は満杯、それ以外は他の書込側に先を越されている。
+                uint64_t sequence = slots_[pos & mask_].sequence.load(std::memory_order_acquire);
+                if((int64_t)(sequence - pos) < 0)
+                    return 0;
+                pos = control_->enqueue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if(control_->enqueue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                for(size_t i = 0; i < n; i++)
+                {
+                    Slot& slot = slots_[(pos + i) & mask_];
+                    std::memcpy(&slot.data, data + i, sizeof(T));
+                    slot.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                notify(control_->enqueue_event, control_->dequeue_waiters);
+                return n;
+            }
+        }
+    }
+
+    /**
+     * @fn push
+     * @brief 1要素の書込処理 キューに空きができるまで待機する。
+     * @note 待機中は futex で休止し、CPU を消費しない。
+     *
+     * @param T data 書き込む構造体変数
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+     * @return true  書込成功
+     * @return false タイムアウト
+     */
+    bool push(const T& data, const int& timeout_msec = 0)
+    {
+        return wait([&]() { return try_push(data); }, control_->dequeue_event, control_->enqueue_waiters, timeout_msec);
+    }
+
+    /**
+     * @fn try_pop
+     * @brief 1要素の読込試行処理
+     *
+     * @param T data 読み取る構造体変数
+     * @return true  読込成功
+     * @return false キューが空のため読込失敗
+     */
+    bool try_pop(T& data)
+    {
+        return try_pop(&data, 1) == 1;
+    }
+
+    /**
+     * @fn try_pop
+     * @brief 複数要素の一括読込試行処理
+     *
+     * @param T* data 読み取る構造体配列の先頭ポインタ
+     * @param size_t count 読み取る最大要素数
+     * @return size_t 実際に読み取った要素数
+     * @note 連続して読込可能なスロット分の読込位置を1回の CAS でまとめて確保する。
+     */
+    size_t try_pop(T* data, const size_t& count)
+    {
+        uint64_t pos = control_->dequeue_pos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            size_t n = 0;
+            while(n < count && n < capacity_ && slots_[(pos + n) & mask_].sequence.load(std::memory_order_acquire) == pos + n + 1)
+                n++;
+            if(n == 0)
+            {
+                // 先頭スロットが書込待ちの場合は空、それ以外は他の読込側に先を越されている。
+                uint64_t sequence = slots_[pos & mask_].sequence.load(std::memory_order_acquire);
+                if((int64_t)(sequence - (pos + 1)) < 0)
+                    return 0;
+                pos = control_->dequeue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if(control_->dequeue_pos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                for(size_t i = 0; i < n; i++)
+                {
+                    Slot& slot = slots_[(pos + i) & mask_];
+                    std::memcpy(data + i, &slot.data, sizeof(T));
+                    slot.sequence.store(pos + i + capacity_, std::memory_order_release);
+                }
+                notify(control_->dequeue_event, control_->enqueue_waiters);
+                return n;
+            }
+        }
+    }
+
+    /**
+     * @fn pop
+     * @brief 1要素の読込処理 キューに要素が書き込まれるまで待機する。
+     * @note 待機中は futex で休止し、CPU を消費しない。
+     *
+     * @param T data 読み取る構造体変数
+     * @param int timeout_msec タイムアウト時間(省略可能) 省略するとタイムアウト時間を設けない
+     * @return true  読込成功
+     * @return false タイムアウト
+     */
+    bool pop(T& data, const int& timeout_msec = 0)
+    {
+        return wait([&]() { return try_pop(data); }, control_->enqueue_event, control_->dequeue_waiters, timeout_msec);
+    }
+
+    /**
+     * @fn size
+     * @brief キューに格納されている要素数の取得
+     * @note 他プロセスが並行して操作している場合は呼出時点の概数となる。
+     */
+    size_t size() const
+    {
+        int64_t size = control_->enqueue_pos.load(std::memory_order_acquire) - control_->dequeue_pos.load(std::memory_order_acquire);
+        return size > 0 ? size : 0;
+    }
+
+    /**
+     * @fn empty
+     * @brief キューが空かどうかの判定
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @fn capacity
+     * @brief キューに格納できる要素数の取得
+     */
+    size_t capacity() const { return capacity_; }
+};
+
+}
+
+#endif // _UTILITY_SHARED_QUEUE_HPP_
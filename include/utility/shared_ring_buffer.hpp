@@ -0,0 +1,191 @@
+/**
+ * @file shared_ring_buffer.hpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 共有メモリ上でプロセス間の1対1メッセージキューを構成する @ref Utility::SharedRingBuffer クラスの定義ヘッダー
+ * @note 本クラス作成にあたって参考にしたリンク集
+ * @n 単一生産者・単一消費者のロックフリーキュー関連 @link https://rigtorp.se/ringbuffer/ @endlink
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef _UTILITY_SHARED_RING_BUFFER_HPP_
+#define _UTILITY_SHARED_RING_BUFFER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#include "utility/shared_memory.hpp"
+
+namespace Utility
+{
+
+/**
+ * @class Utility::SharedRingBuffer
+ * @brief 共有メモリ上の固定長リングバッファによる単一生産者・単一消費者キュー
+ *
+ * @tparam T キューでやりとりする構造体(memcpy でコピー可能な型に限る)
+ * @note 共有メモリの生成・接続は @ref Utility::SharedMemory のコンストラクタ(共有メモリ名から生成するキー)をそのまま使用する。
+ * @n 書込位置・読込位置はそれぞれ別のキャッシュラインに配置し、ロックは使用しない。
+ * @n 書込側(push)・読込側(pop)はそれぞれ1プロセス(1スレッド)に限る。
+ *
+ * @example test/utility/shared_ring_buffer/test_shared_ring_buffer.cpp
+ */
+template<typename T>
+class SharedRingBuffer final
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SharedRingBuffer requires trivially copyable type.");
+
+private:
+    /** 共有メモリ先頭に配置する書込位置・読込位置 */
+    struct Control
+    {
+        alignas(64) std::atomic<uint64_t> head;         /**! 書込位置 書込側のみ更新する */
+        alignas(64) std::atomic<uint64_t> tail;         /**! 読込位置 読込側のみ更新する */
+    };
+
+    uint64_t capacity_;
+    uint64_t mask_;
+    SharedMemory shmem_;
+    Control* control_;
+    T* slots_;
+    uint64_t cached_head_;                              /**! 読込側が最後に参照した書込位置 */
+    uint64_t cached_tail_;                              /**! 書込側が最後に参照した読込位置 */
+
+    static uint64_t round_up(const size_t& capacity)
+    {
+        uint64_t result = 1;
+        while(result < capacity)
+            result <<= 1;
+        return result;
+    }
+
+public:
+
+    /**
+     * @fn SharedRingBuffer
+     * @brief コンストラクタ
+     *
+     * @param const char* shmem_name 共有メモリ名
+     * @param size_t capacity キューに格納できる要素数 2のべき乗に切り上げられる。
+     * @note 同名の共有メモリが異なる要素数・要素サイズで生成済みの場合は例外を送出する。
+     */
+    SharedRingBuffer(const char* shmem_name, const size_t& capacity)
+     :  capacity_(round_up(capacity)),
+        mask_(capacity_ - 1),
+        shmem_(shmem_name, sizeof(Control) + capacity_ * sizeof(T), SharedMemory::NONE),
+        control_(shmem_.get<Control>()),
+        slots_(reinterpret_cast<T*>(shmem_.get<char>() + sizeof(Control))),
+        cached_head_(control_->head.load(std::memory_order_acquire)),
+        cached_tail_(control_->tail.load(std::memory_order_acquire))
+    {}
+
+    SharedRingBuffer(const SharedRingBuffer&) = delete;
+    SharedRingBuffer& operator=(const SharedRingBuffer&) = delete;
+
+    /**
+     * @fn try_push
+     * @brief 1要素の書込試行処理
+     *
+     * @param T data 書き込む構造体変数
+     * @return true  書込成功
+     * @return false キューが満杯のため書込失敗
+     */
+    bool try_push(const T& data)
+    {
+        return try_push(&data, 1) == 1;
+    }
+
+    /**
+     * @fn try_push
+     * @brief 複数要素の一括書込試行処理
+     *
+     * @param T* data 書き込む構造体配列の先頭ポインタ
+     * @param size_t count 書き込む要素数
+     * @return size_t 実際に書き込んだ要素数 キューの空きが不足する場合は count 未満となる。
+     * @note 書込位置の更新は1回のみ行うため、読込側からは一括で見える。
+     */
+    size_t try_push(const T* data, const size_t& count)
+    {
+        uint64_t head = control_->head.load(std::memory_order_relaxed);
+        if(capacity_ - (head - cached_tail_) < count)
+            cached_tail_ = control_->tail.load(std::memory_order_acquire);
+        size_t n = std::min<uint64_t>(count, capacity_ - (head - cached_tail_));
+        if(n == 0)
+            return 0;
+        uint64_t index = head & mask_;
+        size_t first = std::min<uint64_t>(n, capacity_ - index);
+        std::memcpy(slots_ + index, data, first * sizeof(T));
+        std::memcpy(slots_, data + first, (n - first) * sizeof(T));
+        control_->head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @fn try_pop
+     * @brief 1要素の読込試行処理
+     *
+     * @param T data 読み取る構造体変数
+     * @return true  読込成功
+     * @return false キューが空のため読込失敗
+     */
+    bool try_pop(T& data)
+    {
+        return try_pop(&data, 1) == 1;
+    }
+
+    /**
+     * @fn try_pop
+     * @brief 複数要素の一括読込試行処理
+     *
+     * @param T* data 読み取る構造体配列の先頭ポインタ
+     * @param size_t count 読み取る最大要素数
+     * @return size_t 実際に読み取った要素数
+     */
+    size_t try_pop(T* data, const size_t& count)
+    {
+        uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+        if(cached_head_ - tail < count)
+            cached_head_ = control_->head.load(std::memory_order_acquire);
+        size_t n = std::min<uint64_t>(count, cached_head_ - tail);
+        if(n == 0)
+            return 0;
+        uint64_t index = tail & mask_;
+        size_t first = std::min<uint64_t>(n, capacity_ - index);
+        std::memcpy(data, slots_ + index, first * sizeof(T));
+        std::memcpy(data + first, slots_, (n - first) * sizeof(T));
+        control_->tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @fn size
+     * @brief キューに格納されている要素数の取得
+     * @note 他プロセスが並行して操作している場合は呼出時点の概数となる。
+     */
+    size_t size() const
+    {
+        return control_->head.load(std::memory_order_acquire) - control_->tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @fn empty
+     * @brief キューが空かどうかの判定
+     */
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @fn capacity
+     * @brief キューに格納できる要素数の取得
+     */
+    size_t capacity() const { return capacity_; }
+};
+
+}
+
+#endif // _UTILITY_SHARED_RING_BUFFER_HPP_
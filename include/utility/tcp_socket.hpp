@@ -5,6 +5,9 @@
 #include <cstdlib>  
 #include <sstream>
 #include <string>
+#include <cstring>
+#include <vector>
+#include <stdexcept>
 
 #ifdef __unix__
 #include <sys/types.h>
@@ -12,6 +15,7 @@
 #include <netinet/in.h> 
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <cerrno>
 #else
 #include <conio.h>
 #include <winsock2.h>
@@ -38,6 +42,7 @@ using Sock = SOCKET;
 private:
     Sock sock_;
     bool is_open_;
+    std::vector<char> partial_;
     explicit TcpSocket(const Sock& sock);
 
 public:
@@ -80,11 +85,21 @@ public:
      * @tparam T 
      * @param T data 受信する任意の構造体データ 
      * @return true 受信成功
-     * @return false 受信失敗
+     * @return false 受信データなし(ノンブロッキングのソケットで受信待ち)
+     * @note ノンブロッキングのソケットで構造体の途中までしか届いていない場合は、受信済みの部分を保持して false を返す。
+     * @n 次回の呼出時に続きから受信するため、同じソケットでは同じ型で呼び出すこと。
+     * @n 相手側の切断及び受信エラーの場合は例外を送出する。
      */
     template<typename T>
     bool try_read(T& data);
 
+    /**
+     * @fn native_handle
+     * @brief ソケットハンドルのGetterメソッド
+     * @note @ref Utility::EventLoop への登録等、OS の API を直接使用する場合に使用する。
+     */
+    Sock native_handle() const { return sock_; }
+
     /**
      * @fn terminate
      * @brief ソケットをクローズする。
@@ -114,6 +129,7 @@ using Sock = SOCKET;
 private:
     Sock sock_;
     bool is_open_;
+    std::vector<char> partial_;                         /**! ノンブロッキング受信で途中まで受信した構造体データ */
     explicit TcpSocket(const Sock& sock)
      : sock_(sock)
     {}
@@ -183,17 +199,18 @@ public:
     template<typename T>
     bool try_write(const T& data)
     {
-        auto ret = send(sock_, (char*)data, sizeof(data), 0);
+        auto ret = send(sock_, (const char*)&data, sizeof(data), 0);
         if(ret != sizeof(data))
         {
             std::stringstream ss;
 #ifdef __unix__
             ss << "TCP Socket send operation failed. Error Code: " << errno << std::endl;
 #else
-            ss << "TCP Socket send operation failed. Error Code: " << WSALastError() << std::endl;
+            ss << "TCP Socket send operation failed. Error Code: " << WSAGetLastError() << std::endl;
 #endif
             throw std::runtime_error(ss.str());
         }
+        return true;
     }
 
     /**
@@ -203,10 +220,62 @@ public:
      * @tparam T 
      * @param T data 受信する任意の構造体データ 
      * @return true 受信成功
-     * @return false 受信失敗
+     * @return false 受信データなし(ノンブロッキングのソケットで受信待ち)
+     * @note ノンブロッキングのソケットで構造体の途中までしか届いていない場合は、受信済みの部分を保持して false を返す。
+     * @n 次回の呼出時に続きから受信するため、同じソケットでは同じ型で呼び出すこと。
+     * @n 相手側の切断及び受信エラーの場合は例外を送出する。
      */
     template<typename T>
-    bool try_read(T& data);
+    bool try_read(T& data)
+    {
+        // 前回途中まで受信した部分があれば、その続きから受信する。
+        char* buffer = (char*)&data;
+        size_t completed = partial_.size() < sizeof(T) ? partial_.size() : 0;
+        if(completed > 0)
+            std::memcpy(buffer, partial_.data(), completed);
+        partial_.clear();
+        while(completed < sizeof(T))
+        {
+            auto ret = recv(sock_, buffer + completed, sizeof(T) - completed, 0);
+            if(ret > 0)
+            {
+                completed += ret;
+                continue;
+            }
+#ifdef __unix__
+            if(ret < 0 && errno == EINTR)
+                continue;
+            bool is_would_block = (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+#else
+            bool is_would_block = (ret < 0 && WSAGetLastError() == WSAEWOULDBLOCK);
+#endif
+            if(!is_would_block)
+            {
+                std::stringstream ss;
+                if(ret == 0)
+                    ss << "TCP Socket connection closed by peer. Received : " << completed << "/" << sizeof(T) << std::endl;
+                else
+#ifdef __unix__
+                    ss << "TCP Socket recv operation failed. Error Code: " << errno << std::endl;
+#else
+                    ss << "TCP Socket recv operation failed. Error Code: " << WSAGetLastError() << std::endl;
+#endif
+                throw std::runtime_error(ss.str());
+            }
+            // 残りが届くまで待機せず、受信済みの部分を保持して次回の呼出で再開する。
+            if(completed > 0)
+                partial_.assign(buffer, buffer + completed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @fn native_handle
+     * @brief ソケットハンドルのGetterメソッド
+     * @note @ref Utility::EventLoop への登録等、OS の API を直接使用する場合に使用する。
+     */
+    Sock native_handle() const { return sock_; }
 
     /**
      * @fn terminate
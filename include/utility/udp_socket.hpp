@@ -3,12 +3,19 @@
 
 #include <iostream> // cout endl
 #include <cstdlib>  // atoi
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <tuple>
 #include <cstring>
 #include <iomanip>
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#include <atomic>
+#include <memory>
+#include <ctime>
 
 #ifdef __unix__
 #include <sys/types.h>
@@ -16,6 +23,10 @@
 #include <netinet/in.h> // sockaddr_in
 #include <arpa/inet.h>  // inet_addr
 #include <unistd.h>     // close
+#ifdef __linux__
+#include <linux/filter.h> // sock_fprog (SO_ATTACH_REUSEPORT_CBPF)
+#include <linux/net_tstamp.h> // SOF_TIMESTAMPING_*
+#endif
 #else
 #include <conio.h>
 #include <winsock2.h>
@@ -47,6 +58,122 @@ private:
     Sock sock_;                                         /**! ソケットインスタンス   */
     std::vector<struct sockaddr_in> addr_;              /**! 送信先アドレス        */
 
+    static constexpr int BATCH_SIZE = 64;               /**! 1回のシステムコールで送受信する最大メッセージ数 */
+
+    enum TimestampMode { TIMESTAMP_NONE, TIMESTAMP_NS, TIMESTAMPING };
+
+    /**! 受信待ち時間の統計(受信スレッド以外からも参照できるよう atomic とする) */
+    struct DelayStatistics;
+
+    TimestampMode timestamp_mode_;                      /**! カーネル受信時刻の取得方法 */
+    std::shared_ptr<DelayStatistics> delay_statistics_; /**! 受信待ち時間の統計(set_kernel_timestamp で生成) */
+
+    /**! ソケットオプションを設定し、失敗時は例外を送出 */
+    void set_option(const int &level, const int &name, const void *value, const SockLen &len, const char *option_name) const
+    {
+        if (setsockopt(sock_, level, name, (const char *)value, len) == 0)
+            return;
+        std::stringstream ss;
+#ifdef __unix__
+        ss << option_name << " setting failed. error code : " << errno << std::endl;
+#else
+        ss << option_name << " setting failed. error code : " << WSAGetLastError() << std::endl;
+#endif
+        throw std::runtime_error(ss.str());
+    }
+
+    /**! IPアドレス文字列を変換(空文字列は INADDR_ANY) */
+    static struct in_addr to_in_addr(const std::string &ip)
+    {
+        struct in_addr addr;
+        std::memset(&addr, 0, sizeof(addr));
+        if (!ip.empty() && inet_pton(AF_INET, ip.c_str(), &addr) != 1)
+            throw std::runtime_error("invalid IPv4 address : " + ip);
+        return addr;
+    }
+
+public:
+
+    /**! バッチ送受信の1メッセージ分の情報 */
+    struct Message
+    {
+        char* buffer;                                   /**! 送受信バッファ(呼出側で確保する)           */
+        int capacity;                                   /**! 受信時 バッファのサイズ                     */
+        int length;                                     /**! 送信時 送信するサイズ / 受信時 受信したサイズ */
+        struct sockaddr_in source;                      /**! 受信時 送信元アドレス                       */
+        bool truncated;                                 /**! 受信時 capacity を超えたため切り詰めた       */
+        int64_t timestamp_nsec;                         /**! 受信時 カーネルの受信時刻(UNIX時刻ナノ秒) set_kernel_timestamp 未設定時は0 */
+        int64_t delay_nsec;                             /**! 受信時 カーネル受信からアプリケーションが取得するまでの待ち時間(ナノ秒) */
+    };
+
+    static constexpr size_t DELAY_BUCKETS = 24;         /**! 受信待ち時間ヒストグラムの区間数 */
+
+    /**! 受信待ち時間の統計 histogram[0] は1マイクロ秒未満、histogram[i] は 2^(i-1) 以上 2^i 未満マイクロ秒の受信数(最後の区間は上限なし) */
+    struct DelayStats
+    {
+        uint64_t count;                                 /**! 受信時刻を取得できた受信数 */
+        uint64_t total_nsec;                            /**! 待ち時間の合計(ナノ秒)     */
+        uint64_t max_nsec;                              /**! 待ち時間の最大値(ナノ秒)   */
+        uint64_t histogram[DELAY_BUCKETS];              /**! 待ち時間の対数ヒストグラム */
+    };
+
+private:
+    struct DelayStatistics
+    {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> total_nsec;
+        std::atomic<uint64_t> max_nsec;
+        std::atomic<uint64_t> histogram[DELAY_BUCKETS];
+    };
+
+#ifdef __unix__
+    /**! 制御メッセージから受信時刻を取り出し、待ち時間を算出して統計へ加算 */
+    void apply_timestamp(struct msghdr &header, Message &m, const struct timespec &now) const
+    {
+        m.timestamp_nsec = 0;
+        m.delay_nsec     = 0;
+        const struct timespec *stamp = nullptr;
+        for (struct cmsghdr *c = CMSG_FIRSTHDR(&header); c != nullptr; c = CMSG_NXTHDR(&header, c))
+        {
+            if (c->cmsg_level != SOL_SOCKET)
+                continue;
+#ifdef SO_TIMESTAMPNS
+            if (c->cmsg_type == SCM_TIMESTAMPNS)
+                stamp = (const struct timespec *)CMSG_DATA(c);
+#endif
+#ifdef SO_TIMESTAMPING
+            // [0] ソフトウェア時刻 [2] ハードウェア時刻 ハードウェア時刻を優先する。
+            if (c->cmsg_type == SCM_TIMESTAMPING)
+            {
+                const struct timespec *stamps = (const struct timespec *)CMSG_DATA(c);
+                stamp = (stamps[2].tv_sec != 0 || stamps[2].tv_nsec != 0) ? &stamps[2] : &stamps[0];
+            }
+#endif
+        }
+        if (stamp == nullptr || (stamp->tv_sec == 0 && stamp->tv_nsec == 0))
+            return;
+        m.timestamp_nsec = (int64_t)stamp->tv_sec * 1000000000 + stamp->tv_nsec;
+        int64_t delay = ((int64_t)now.tv_sec * 1000000000 + now.tv_nsec) - m.timestamp_nsec;
+        m.delay_nsec  = delay > 0 ? delay : 0;
+
+        DelayStatistics &statistics = *delay_statistics_;
+        uint64_t delay_nsec = (uint64_t)m.delay_nsec;
+        statistics.count.fetch_add(1, std::memory_order_relaxed);
+        statistics.total_nsec.fetch_add(delay_nsec, std::memory_order_relaxed);
+        uint64_t max = statistics.max_nsec.load(std::memory_order_relaxed);
+        while (delay_nsec > max && !statistics.max_nsec.compare_exchange_weak(max, delay_nsec, std::memory_order_relaxed))
+            ;
+        uint64_t delay_usec = delay_nsec / 1000;
+        size_t bucket = 0;
+        while (delay_usec > 0 && bucket < DELAY_BUCKETS - 1)
+        {
+            delay_usec >>= 1;
+            bucket++;
+        }
+        statistics.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+
 public:
 
     UdpSocket()
@@ -58,6 +185,7 @@ public:
             throw std::runtime_error("failed to initialize Winsock DLL");
 #endif
         sock_ = socket(AF_INET, SOCK_DGRAM, 0);
+        timestamp_mode_ = TIMESTAMP_NONE;
     }
 
     ~UdpSocket()
@@ -70,6 +198,9 @@ public:
 #endif
     }
 
+    /**! ソケットハンドルを取得(EventLoop への登録等、OS の API を直接使用する場合) */
+    Sock native_handle() const { return sock_; }
+
     /**! 受信ポートを設定 */
     UdpSocket& set_listen_port(const int& port)
     {
@@ -117,11 +248,210 @@ public:
         return *this;
     }
 
+    /**! アドレス再利用を設定(同一ホストの複数プロセスで同じ受信ポートを使用する場合に set_listen_port より前に呼び出す) */
+    UdpSocket& set_reuse_address(const bool& enable = true)
+    {
+        int value = enable ? 1 : 0;
+        set_option(SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value), "SO_REUSEADDR");
+        return *this;
+    }
+
+    /**! ポート共有を設定(SO_REUSEPORT) 同じポートに set_listen_port した複数ソケットへカーネルが受信を振り分ける。
+     *   set_listen_port より前に呼び出す。 */
+    UdpSocket& set_reuse_port(const bool& enable = true)
+    {
+#ifdef SO_REUSEPORT
+        int value = enable ? 1 : 0;
+        set_option(SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value), "SO_REUSEPORT");
+#else
+        if (enable)
+            throw std::runtime_error("SO_REUSEPORT is not supported on this platform.");
+#endif
+        return *this;
+    }
+
+    /**! SO_REUSEPORT で同じポートを共有するソケットへの振り分けを送信元アドレス・ポートで固定する(Linux のみ)
+     *   (送信元IPv4アドレス ^ 送信元ポート) % shard_count 番目(set_listen_port した順)のソケットへ振り分け、
+     *   同じ送信元のデータグラムは常に同じソケットで受信する。グループ内のいずれか1つのソケットで呼び出せばよい。
+     *   振り分け先の番号はカーネルの SO_REUSEPORT グループへの参加順であり、同じポートに他のソケット(他プロセスを含む)が
+     *   先に参加していると set_listen_port した順と一致しない。
+     *   送信元ポートは SKF_NET_OFF + 20 で参照するため、オプションなしのIPv4ヘッダ(20バイト)を前提とする。
+     *   IPv6 やオプション付きのIPv4ヘッダでは振り分け先が送信元で固定されない。 */
+    UdpSocket& set_reuse_port_steering(const int& shard_count)
+    {
+        if (shard_count < 1)
+            throw std::runtime_error("shard_count must be larger than 0.");
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+        // 実行時にはUDPヘッダ分進んだ位置がデータ先頭となるため、IPヘッダは SKF_NET_OFF 基準で参照する(オプションなしのIPv4ヘッダを前提)。
+        struct sock_filter code[] = {
+            { BPF_LD  | BPF_W | BPF_ABS, 0, 0, (uint32_t)(SKF_NET_OFF + 12) },    // A = 送信元アドレス
+            { BPF_MISC | BPF_TAX,        0, 0, 0 },                               // X = A
+            { BPF_LD  | BPF_H | BPF_ABS, 0, 0, (uint32_t)(SKF_NET_OFF + 20) },    // A = 送信元ポート
+            { BPF_ALU | BPF_XOR | BPF_X, 0, 0, 0 },                               // A ^= X
+            { BPF_ALU | BPF_MOD | BPF_K, 0, 0, (uint32_t)shard_count },           // A %= shard_count
+            { BPF_RET | BPF_A,           0, 0, 0 },
+        };
+        struct sock_fprog program;
+        program.len    = sizeof(code) / sizeof(code[0]);
+        program.filter = code;
+        set_option(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program), "SO_ATTACH_REUSEPORT_CBPF");
+#else
+        throw std::runtime_error("SO_ATTACH_REUSEPORT_CBPF is not supported on this platform.");
+#endif
+        return *this;
+    }
+
+    /**! カーネル受信時刻の取得を設定 有効時は Message で受信する API が受信時刻・待ち時間を返し、待ち時間を delay_stats に集計する。
+     *   use_hardware を指定すると SO_TIMESTAMPING でNICのハードウェア時刻を優先して取得する(NIC側でハードウェアタイムスタンプの有効化が必要)。
+     *   ハードウェア時刻はNICの時計が PTP 等でシステム時刻と同期していない場合、待ち時間が正しく算出されない。 */
+    UdpSocket& set_kernel_timestamp(const bool& enable = true, const bool& use_hardware = false)
+    {
+#if defined(__unix__) && defined(SO_TIMESTAMPNS)
+        int off = 0;
+        if (!enable)
+        {
+            if (timestamp_mode_ == TIMESTAMP_NS)
+                set_option(SOL_SOCKET, SO_TIMESTAMPNS, &off, sizeof(off), "SO_TIMESTAMPNS");
+#ifdef SO_TIMESTAMPING
+            if (timestamp_mode_ == TIMESTAMPING)
+                set_option(SOL_SOCKET, SO_TIMESTAMPING, &off, sizeof(off), "SO_TIMESTAMPING");
+#endif
+            timestamp_mode_ = TIMESTAMP_NONE;
+            return *this;
+        }
+        if (!delay_statistics_)
+            delay_statistics_ = std::make_shared<DelayStatistics>();
+        if (use_hardware)
+        {
+#if defined(SO_TIMESTAMPING) && defined(__linux__)
+            int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE
+                      | SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+            set_option(SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags), "SO_TIMESTAMPING");
+            timestamp_mode_ = TIMESTAMPING;
+            return *this;
+#else
+            throw std::runtime_error("SO_TIMESTAMPING is not supported on this platform.");
+#endif
+        }
+        int on = 1;
+        set_option(SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on), "SO_TIMESTAMPNS");
+        timestamp_mode_ = TIMESTAMP_NS;
+#else
+        if (enable)
+            throw std::runtime_error("SO_TIMESTAMPNS is not supported on this platform.");
+#endif
+        return *this;
+    }
+
+    /**! 受信待ち時間の統計を取得(set_kernel_timestamp 未設定時は全て0) */
+    DelayStats delay_stats() const
+    {
+        DelayStats stats;
+        std::memset(&stats, 0, sizeof(stats));
+        if (!delay_statistics_)
+            return stats;
+        stats.count      = delay_statistics_->count.load(std::memory_order_relaxed);
+        stats.total_nsec = delay_statistics_->total_nsec.load(std::memory_order_relaxed);
+        stats.max_nsec   = delay_statistics_->max_nsec.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < DELAY_BUCKETS; i++)
+            stats.histogram[i] = delay_statistics_->histogram[i].load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /**! 受信待ち時間の統計をリセット */
+    void reset_delay_stats()
+    {
+        if (!delay_statistics_)
+            return;
+        delay_statistics_->count.store(0, std::memory_order_relaxed);
+        delay_statistics_->total_nsec.store(0, std::memory_order_relaxed);
+        delay_statistics_->max_nsec.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < DELAY_BUCKETS; i++)
+            delay_statistics_->histogram[i].store(0, std::memory_order_relaxed);
+    }
+
+    /**! マルチキャストグループに参加(interface_ip を省略するとカーネルが選択したインターフェースで受信)
+     *   送信側は set_target_ports でグループアドレスを1つ指定すれば、1回の sendto で全購読者へ届く。 */
+    UdpSocket& join_group(const std::string& group_ip, const std::string& interface_ip = "")
+    {
+        struct ip_mreq mreq;
+        mreq.imr_multiaddr = to_in_addr(group_ip);
+        mreq.imr_interface = to_in_addr(interface_ip);
+        set_option(IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq), "IP_ADD_MEMBERSHIP");
+        return *this;
+    }
+
+    /**! マルチキャストグループから離脱 */
+    UdpSocket& leave_group(const std::string& group_ip, const std::string& interface_ip = "")
+    {
+        struct ip_mreq mreq;
+        mreq.imr_multiaddr = to_in_addr(group_ip);
+        mreq.imr_interface = to_in_addr(interface_ip);
+        set_option(IPPROTO_IP, IP_DROP_MEMBERSHIP, &mreq, sizeof(mreq), "IP_DROP_MEMBERSHIP");
+        return *this;
+    }
+
+    /**! 送信元を限定してマルチキャストグループに参加(ソース指定マルチキャスト) */
+    UdpSocket& join_source_group(const std::string& group_ip, const std::string& source_ip, const std::string& interface_ip = "")
+    {
+        struct ip_mreq_source mreq;
+        std::memset(&mreq, 0, sizeof(mreq));
+        mreq.imr_multiaddr  = to_in_addr(group_ip);
+        mreq.imr_sourceaddr = to_in_addr(source_ip);
+        mreq.imr_interface  = to_in_addr(interface_ip);
+        set_option(IPPROTO_IP, IP_ADD_SOURCE_MEMBERSHIP, &mreq, sizeof(mreq), "IP_ADD_SOURCE_MEMBERSHIP");
+        return *this;
+    }
+
+    /**! ソース指定マルチキャストグループから離脱 */
+    UdpSocket& leave_source_group(const std::string& group_ip, const std::string& source_ip, const std::string& interface_ip = "")
+    {
+        struct ip_mreq_source mreq;
+        std::memset(&mreq, 0, sizeof(mreq));
+        mreq.imr_multiaddr  = to_in_addr(group_ip);
+        mreq.imr_sourceaddr = to_in_addr(source_ip);
+        mreq.imr_interface  = to_in_addr(interface_ip);
+        set_option(IPPROTO_IP, IP_DROP_SOURCE_MEMBERSHIP, &mreq, sizeof(mreq), "IP_DROP_SOURCE_MEMBERSHIP");
+        return *this;
+    }
+
+    /**! マルチキャスト送信時の TTL を設定(既定は1 同一サブネット内のみ) */
+    UdpSocket& set_multicast_ttl(const int& ttl)
+    {
+#ifdef __unix__
+        unsigned char value = ttl;
+#else
+        DWORD value = ttl;
+#endif
+        set_option(IPPROTO_IP, IP_MULTICAST_TTL, &value, sizeof(value), "IP_MULTICAST_TTL");
+        return *this;
+    }
+
+    /**! 自ホストで送信したマルチキャストを自ホストの購読者にも配送するかを設定(既定は有効) */
+    UdpSocket& set_multicast_loopback(const bool& enable)
+    {
+#ifdef __unix__
+        unsigned char value = enable ? 1 : 0;
+#else
+        DWORD value = enable ? 1 : 0;
+#endif
+        set_option(IPPROTO_IP, IP_MULTICAST_LOOP, &value, sizeof(value), "IP_MULTICAST_LOOP");
+        return *this;
+    }
+
+    /**! マルチキャストを送信するインターフェースを IP アドレスで指定 */
+    UdpSocket& set_multicast_interface(const std::string& interface_ip)
+    {
+        struct in_addr addr = to_in_addr(interface_ip);
+        set_option(IPPROTO_IP, IP_MULTICAST_IF, &addr, sizeof(addr), "IP_MULTICAST_IF");
+        return *this;
+    }
+
     /**! 受信タイムアウト設定 */
     UdpSocket& set_timeout(const double& timeout_msec)
     {
         if (timeout_msec <= 0)
-            throw std::runtime_error("timeout must be lager than 0.");
+            throw std::runtime_error("timeout must be larger than 0.");
 
         int sec = timeout_msec / 1000.;
         int u_sec = 1000000 * (timeout_msec / 1000. - (int)(timeout_msec / 1000.));
@@ -160,40 +490,159 @@ public:
         return true;
     }
 
-    /**! 可変長データをstringとして取得 */
+    /**! 複数データグラムを1回のシステムコール(recvmmsg)で受信し、受信数を返す(受信できなければ0)
+     *   1件目の到着までは set_timeout の設定に従って待機し、以降は到着済みの分のみを受信する。
+     *   set_kernel_timestamp 設定時は各メッセージにカーネル受信時刻・待ち時間を格納する。 */
+    int try_read_batch(Message *messages, const int &count) const
+    {
+        int received = 0;
+        if (count < 1)
+            return received;
+#ifdef __unix__
+        struct mmsghdr headers[BATCH_SIZE];
+        struct iovec vectors[BATCH_SIZE];
+        alignas(cmsghdr) char controls[BATCH_SIZE][CMSG_SPACE(sizeof(struct timespec) * 3)];
+        bool has_timestamp = (timestamp_mode_ != TIMESTAMP_NONE);
+        while (received < count)
+        {
+            int n = (count - received < BATCH_SIZE) ? count - received : BATCH_SIZE;
+            for (int i = 0; i < n; i++)
+            {
+                Message &m = messages[received + i];
+                vectors[i].iov_base = m.buffer;
+                vectors[i].iov_len  = m.capacity;
+                std::memset(&headers[i], 0, sizeof(struct mmsghdr));
+                headers[i].msg_hdr.msg_name    = &m.source;
+                headers[i].msg_hdr.msg_namelen = sizeof(m.source);
+                headers[i].msg_hdr.msg_iov     = &vectors[i];
+                headers[i].msg_hdr.msg_iovlen  = 1;
+                if (has_timestamp)
+                {
+                    headers[i].msg_hdr.msg_control    = controls[i];
+                    headers[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+                }
+            }
+            int r = recvmmsg(sock_, headers, n, (received == 0) ? MSG_WAITFORONE : MSG_DONTWAIT, nullptr);
+            if (r < 1)
+                break;
+            struct timespec now;
+            if (has_timestamp)
+                clock_gettime(CLOCK_REALTIME, &now);
+            for (int i = 0; i < r; i++)
+            {
+                Message &m = messages[received + i];
+                m.length    = std::min((int)headers[i].msg_len, m.capacity);
+                m.truncated = (headers[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+                if (has_timestamp)
+                    apply_timestamp(headers[i].msg_hdr, m, now);
+                else
+                    m.timestamp_nsec = m.delay_nsec = 0;
+            }
+            received += r;
+            if (r < n)
+                break;
+        }
+#else
+        // recvmmsg がないため1件のみ受信する。
+        Message &m = messages[0];
+        SockLen len = sizeof(m.source);
+        m.length    = recvfrom(sock_, m.buffer, m.capacity, 0, (struct sockaddr *)&m.source, &len);
+        m.truncated = (m.length < 0 && WSAGetLastError() == WSAEMSGSIZE);
+        if (m.truncated)
+            m.length = m.capacity;
+        m.timestamp_nsec = m.delay_nsec = 0;
+        if (m.length >= 0)
+            received = 1;
+#endif
+        return received;
+    }
+
+    /**! 複数データグラムを1回のシステムコール(sendmmsg)で指定した送信先へ送信し、送信できた数を返す */
+    int try_write_batch(const Message *messages, const int &count, const size_t &target_index) const
+    {
+        if (target_index >= addr_.size())
+            throw std::runtime_error("No target is setted.");
+        int sent = 0;
+#ifdef __unix__
+        struct mmsghdr headers[BATCH_SIZE];
+        struct iovec vectors[BATCH_SIZE];
+        while (sent < count)
+        {
+            int n = (count - sent < BATCH_SIZE) ? count - sent : BATCH_SIZE;
+            for (int i = 0; i < n; i++)
+            {
+                const Message &m = messages[sent + i];
+                vectors[i].iov_base = m.buffer;
+                vectors[i].iov_len  = m.length;
+                std::memset(&headers[i], 0, sizeof(struct mmsghdr));
+                headers[i].msg_hdr.msg_name    = (void *)&addr_[target_index];
+                headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+                headers[i].msg_hdr.msg_iov     = &vectors[i];
+                headers[i].msg_hdr.msg_iovlen  = 1;
+            }
+            int r = sendmmsg(sock_, headers, n, 0);
+            if (r < 1)
+                break;
+            sent += r;
+        }
+#else
+        for (; sent < count; sent++)
+            if (sendto(sock_, messages[sent].buffer, messages[sent].length, 0, (struct sockaddr *)&addr_[target_index], sizeof(struct sockaddr_in)) != messages[sent].length)
+                break;
+#endif
+        return sent;
+    }
+
+    /**! 複数データグラムを全送信先へ送信し、全送信先へ送信できた数を返す */
+    int try_write_batch(const Message *messages, const int &count) const
+    {
+        if (addr_.size() < 1)
+            throw std::runtime_error("No target is setted.");
+        int sent = count;
+        for (size_t i = 0; i < addr_.size(); i++)
+            sent = std::min(sent, try_write_batch(messages, count, i));
+        return sent;
+    }
+
+    /**! 可変長データをstringとして取得
+     *   buffer の確保済み領域へ直接受信するため、同じ string を使い回せば2回目以降は動的確保を行わない。 */
     bool try_read_string(std::string& buffer, const int& buffer_capacity=1024) const
     {
-        char* tmp = new char[buffer_capacity];
-        int len;
-        if(len = recv(sock_, tmp, buffer_capacity, 0) < 1)
+        buffer.resize(buffer_capacity);
+        int len = recv(sock_, &buffer[0], buffer_capacity, 0);
+        if (len < 1)
         {
-            delete[] tmp;
+            buffer.clear();
             return false;
         }
-        buffer = std::string(tmp, len);
-        delete[] tmp;
+        buffer.resize(len);
         return true;
     }
 
-    /**! 固定長データをchar*として受信 */
+    /**! 1データグラムをchar*として受信し、受信サイズを取得(capacityを超える分は破棄) */
+    bool try_read_datagram(char *buffer, const int &capacity, int &length) const
+    {
+        length = recv(sock_, buffer, capacity, 0);
+        if (length < 0)
+        {
+            length = 0;
+            return false;
+        }
+        return true;
+    }
+
+    /**! 固定長データをchar*として受信
+     *   呼出側のバッファへ直接受信する。複数データグラムに分かれて途中で失敗した場合、受信済みの部分は上書きされる。 */
     bool try_read(char *buffer, const int &len) const
     {
-        char *tmp = new char[len];
-        int remain = len;
         int completed = 0;
         while (completed < len)
         {
-            int r = recv(sock_, tmp + completed, remain, 0);
+            int r = recv(sock_, buffer + completed, len - completed, 0);
             if (r < 1)
-            {
-                delete[] tmp;
                 return false;
-            }
             completed += r;
-            remain -= r;
-        };
-        std::memcpy(buffer, tmp, len);
-        delete[] tmp;
+        }
         return true;
     }
 
@@ -201,24 +650,57 @@ public:
     template <typename T>
     bool try_read(T &data) const
     {
-        int len = sizeof(T);
-        char *tmp = new char[len];
-        int remain = len;
-        int completed = 0;
-        while (completed < len)
+        return try_read((char *)&data, sizeof(T));
+    }
+
+    /**! 1データグラムを message.buffer へ受信(set_kernel_timestamp 設定時はカーネル受信時刻・待ち時間も取得) */
+    bool try_read(Message &message) const
+    {
+        return try_read_batch(&message, 1) == 1;
+    }
+
+    /**! 受信用バッファプール
+     *   生成時に slots 個 x slot_size バイトの領域を一度だけ確保し、try_read(BufferPool&) で繰り返し使用する。
+     *   受信結果は各スロットへの参照(Message)として取得し、次の受信まで有効とする。 */
+    class BufferPool final
+    {
+        friend class UdpSocket;
+
+    private:
+        std::vector<char> storage_;                     /**! 全スロットの領域       */
+        std::vector<Message> messages_;                 /**! スロット毎の受信情報   */
+        int count_;                                     /**! 直近に受信したメッセージ数 */
+
+    public:
+        BufferPool(const int &slots, const int &slot_size)
+         :  storage_((size_t)slots * slot_size), messages_(slots), count_(0)
         {
-            int r = recv(sock_, tmp + completed, remain, 0);
-            if (r < 1)
+            for (int i = 0; i < slots; i++)
             {
-                delete[] tmp;
-                return false;
+                messages_[i].buffer    = storage_.data() + (size_t)i * slot_size;
+                messages_[i].capacity  = slot_size;
+                messages_[i].length    = 0;
+                messages_[i].truncated = false;
+                messages_[i].timestamp_nsec = 0;
+                messages_[i].delay_nsec     = 0;
             }
-            completed += r;
-            remain -= r;
-        };
-        std::memcpy(&data, tmp, len);
-        delete[] tmp;
-        return true;
+        }
+
+        /**! 直近に受信したメッセージ数 */
+        int size() const { return count_; }
+
+        /**! 直近に受信した i 番目のメッセージ buffer は次の受信まで有効 */
+        const Message &operator[](const int &i) const { return messages_[i]; }
+
+        const Message *begin() const { return messages_.data(); }
+        const Message *end() const { return messages_.data() + count_; }
+    };
+
+    /**! バッファプールへ一括受信し、受信数を返す(受信できなければ0) 受信処理中に動的確保・コピーを行わない。 */
+    int try_read(BufferPool &pool) const
+    {
+        pool.count_ = try_read_batch(pool.messages_.data(), (int)pool.messages_.size());
+        return pool.count_;
     }
 };
 
@@ -0,0 +1,13 @@
+#ifndef _TEST_UTILITY_EVENT_LOOP_SAMPLE_DATA_HPP_
+#define _TEST_UTILITY_EVENT_LOOP_SAMPLE_DATA_HPP_
+
+struct Sample
+{
+    unsigned long sequence;
+    double values[16];
+};
+
+static constexpr int BASE_PORT = 8020;
+static constexpr int SOCKET_COUNT = 4;
+
+#endif
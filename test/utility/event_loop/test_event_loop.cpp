@@ -0,0 +1,161 @@
+/**
+ * @file test_event_loop.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::EventLoop のテストコード及びクライアントコード例
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "./sample_data.hpp"
+#include "utility/event_loop.hpp"
+
+int main()
+{
+    using Utility::EventLoop;
+    using Utility::UdpSocket;
+
+    static constexpr int MESSAGES = 1000;
+
+    int fail = 0;
+
+    // 1つのループで複数の受信ソケットとタイマーを処理する。
+    {
+        std::vector<std::unique_ptr<UdpSocket>> receivers;
+        std::vector<int> received(SOCKET_COUNT, 0);
+        EventLoop loop;
+        for(int i = 0; i < SOCKET_COUNT; i++)
+        {
+            receivers.emplace_back(new UdpSocket());
+            receivers.back()->set_listen_port(BASE_PORT + i);
+            auto& socket = *receivers.back();
+            auto& count  = received[i];
+            loop.add(socket, [&socket, &count]()
+            {
+                Sample sample;
+                if(!socket.try_read(sample))
+                    return false;
+                count++;
+                return true;
+            });
+        }
+
+        int ticks = 0;
+        loop.add_timer(10, [&ticks]() { ticks++; });
+        int once = 0;
+        loop.add_timer(1, [&once]() { once++; }, false);
+
+        UdpSocket sender;
+        std::vector<int> ports;
+        for(int i = 0; i < SOCKET_COUNT; i++)
+            ports.push_back(BASE_PORT + i);
+        sender.set_target_ports(ports);
+
+        Sample sample = {};
+        int expected = 0;
+        for(int i = 0; i < MESSAGES; i++)
+        {
+            sample.sequence = i;
+            sender.try_write(sample);
+            expected++;
+            // 送信側が受信側を大きく追い越してカーネルのバッファが溢れないよう、適宜処理する。
+            if(i % 64 == 0)
+                while(loop.run_once(0) > 0)
+                    ;
+        }
+        auto start = std::chrono::steady_clock::now();
+        while(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100))
+            loop.run_once(10);
+
+        for(int i = 0; i < SOCKET_COUNT; i++)
+        {
+            std::cout << "port " << BASE_PORT + i << " received " << received[i] << "/" << expected << std::endl;
+            if(received[i] != expected)
+                fail++;
+        }
+        std::cout << "timer ticks " << ticks << ", one-shot " << once << std::endl;
+        if(ticks < 5 || once != 1)
+            fail++;
+    }
+
+    // コア毎に1つずつループを生成し、別スレッドで run する。
+    {
+        unsigned int cores = std::thread::hardware_concurrency();
+        if(cores == 0)
+            cores = 1;
+        static constexpr int loops = 2;
+
+        std::vector<std::unique_ptr<UdpSocket>> receivers;
+        std::vector<std::unique_ptr<EventLoop>> event_loops;
+        std::vector<std::atomic<int>> received(loops);
+        for(int i = 0; i < loops; i++)
+        {
+            received[i].store(0);
+            receivers.emplace_back(new UdpSocket());
+            receivers.back()->set_listen_port(BASE_PORT + SOCKET_COUNT + i);
+            event_loops.emplace_back(new EventLoop(cores > 1 ? (int)(i % cores) : -1));
+            auto& socket = *receivers.back();
+            auto& count  = received[i];
+            event_loops.back()->add(socket, [&socket, &count]()
+            {
+                Sample sample;
+                if(!socket.try_read(sample))
+                    return false;
+                count++;
+                return true;
+            });
+        }
+
+        std::vector<std::thread> threads;
+        for(auto& loop : event_loops)
+            threads.emplace_back([&loop]() { loop->run(); });
+
+        UdpSocket sender;
+        std::vector<int> ports;
+        for(int i = 0; i < loops; i++)
+            ports.push_back(BASE_PORT + SOCKET_COUNT + i);
+        sender.set_target_ports(ports);
+        Sample sample = {};
+        for(int i = 0; i < MESSAGES; i++)
+        {
+            sample.sequence = i;
+            sender.try_write(sample);
+            if(i % 64 == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        for(auto& loop : event_loops)
+            loop->stop();
+        for(auto& thread : threads)
+            thread.join();
+
+        for(int i = 0; i < loops; i++)
+        {
+            std::cout << "loop " << i << " received " << received[i].load() << "/" << MESSAGES << std::endl;
+            if(received[i].load() != MESSAGES)
+                fail++;
+        }
+    }
+
+    // run の開始前に stop した場合も run は終了する。
+    {
+        EventLoop loop;
+        std::thread thread([&loop]() { loop.stop(); });
+        thread.join();
+        loop.run();
+        std::cout << "stop before run returned" << std::endl;
+    }
+
+    std::cout << (fail == 0 ? "OK" : "NG") << std::endl;
+    return fail == 0 ? 0 : 1;
+}
@@ -0,0 +1,13 @@
+#ifndef _TEST_UTILITY_SHARDED_UDP_RECEIVER_SAMPLE_DATA_HPP_
+#define _TEST_UTILITY_SHARDED_UDP_RECEIVER_SAMPLE_DATA_HPP_
+
+struct Sample
+{
+    int sender;
+    unsigned long sequence;
+    double values[16];
+};
+
+static constexpr int RECEIVER_PORT = 8030;
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file test_sharded_udp_receiver.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::ShardedUdpReceiver のテストコード及びクライアントコード例
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "./sample_data.hpp"
+#include "utility/sharded_udp_receiver.hpp"
+
+int main()
+{
+    using Utility::ShardedUdpReceiver;
+    using Utility::UdpSocket;
+
+    static constexpr int SHARDS   = 4;
+    static constexpr int SENDERS  = 16;
+    static constexpr int MESSAGES = 2000;
+
+    int fail = 0;
+
+    // コア数分のコアに受信スレッドを割り当てる。
+    std::vector<int> cores;
+    unsigned int hardware = std::thread::hardware_concurrency();
+    for(int i = 0; i < SHARDS; i++)
+        cores.push_back(hardware > 1 ? (int)(i % hardware) : -1);
+
+    ShardedUdpReceiver<Sample> receiver(RECEIVER_PORT, SHARDS, 1 << 14, cores);
+    receiver.set_kernel_timestamp().start();
+
+    // 送信元ポートが異なる複数の送信ソケットから送信する。
+    std::vector<std::unique_ptr<UdpSocket>> senders;
+    for(int i = 0; i < SENDERS; i++)
+    {
+        senders.emplace_back(new UdpSocket());
+        senders.back()->set_target_ports(std::vector<int>{RECEIVER_PORT});
+    }
+
+    Sample sample = {};
+    for(int i = 0; i < MESSAGES; i++)
+    {
+        sample.sequence = i;
+        for(int j = 0; j < SENDERS; j++)
+        {
+            sample.sender = j;
+            senders[j]->try_write(sample);
+        }
+        // 受信側のソケットバッファが溢れないよう送信レートを抑える。
+        if(i % 8 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 各シャードを読み出し、送信元毎に1つのシャードへ順序通り届いていることを確認する。
+    std::vector<int> shard_of(SENDERS, -1);
+    std::vector<unsigned long> next(SENDERS, 0);
+    std::vector<Sample> buffer(256);
+    auto start = std::chrono::steady_clock::now();
+    while(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500))
+    {
+        for(int s = 0; s < SHARDS; s++)
+        {
+            size_t n = receiver.try_pop(s, buffer.data(), buffer.size());
+            for(size_t k = 0; k < n; k++)
+            {
+                const Sample& received = buffer[k];
+                if(shard_of[received.sender] == -1)
+                    shard_of[received.sender] = s;
+                if(shard_of[received.sender] != s || received.sequence != next[received.sender])
+                    fail++;
+                next[received.sender] = received.sequence + 1;
+            }
+        }
+    }
+    receiver.stop();
+
+    for(int s = 0; s < SHARDS; s++)
+    {
+        std::cout << "shard " << s << " received " << receiver.received(s)
+                  << " dropped " << receiver.dropped(s) << " invalid " << receiver.invalid(s);
+        // ソケットバッファでの待ち時間 全受信分が集計されていることを確認する。
+        auto delay = receiver.delay_stats(s);
+        std::cout << " delay max " << delay.max_nsec / 1000 << "usec" << std::endl;
+        if(receiver.dropped(s) != 0 || receiver.invalid(s) != 0 || delay.count != receiver.received(s))
+            fail++;
+    }
+    for(int j = 0; j < SENDERS; j++)
+    {
+        // 振り分け先は (送信元アドレス ^ 送信元ポート) % SHARDS 番目のシャードとなる。
+        struct sockaddr_in local;
+        socklen_t len = sizeof(local);
+        getsockname(senders[j]->native_handle(), (struct sockaddr*)&local, &len);
+        int expected = (int)((INADDR_LOOPBACK ^ ntohs(local.sin_port)) % SHARDS);
+        std::cout << "sender " << j << " -> shard " << shard_of[j] << " (expected " << expected << ") "
+                  << next[j] << "/" << MESSAGES << std::endl;
+        if(next[j] != MESSAGES || shard_of[j] != expected)
+            fail++;
+    }
+
+    std::cout << (fail == 0 ? "OK" : "NG") << std::endl;
+    return fail == 0 ? 0 : 1;
+}
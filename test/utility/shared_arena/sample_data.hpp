@@ -0,0 +1,13 @@
+#ifndef _TEST_UTILITY_SHARED_ARENA_SAMPLE_DATA_HPP_
+#define _TEST_UTILITY_SHARED_ARENA_SAMPLE_DATA_HPP_
+
+struct Point
+{
+    float x;
+    float y;
+    float z;
+};
+
+static constexpr char SM_DATA_PATH[32] = "SAMPLE_ARENA";
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file test_shared_arena.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedArena クラスのテストコード及びクライアントコード例
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "./sample_data.hpp"
+#include "utility/shared_arena.hpp"
+
+int main()
+{
+    using Utility::SharedArena;
+    using Utility::SharedVector;
+    using Utility::SharedString;
+
+    static constexpr size_t POINTS = 100000;
+
+    // 共有メモリ上にアリーナを生成
+    // 第一引数 : 共有メモリ名
+    // 第二引数 : 共有メモリ全体のサイズ
+    SharedArena arena(SM_DATA_PATH, 16 * 1024 * 1024);
+
+    // 名前付きオブジェクトの生成 他プロセスからは同じ名前で取得する。
+    auto cloud = arena.find_or_construct<SharedVector<Point>>("cloud", arena);
+    auto label = arena.find_or_construct<SharedString>("label", arena);
+
+    // 子プロセスを書込側とする。
+    if(fork() == 0)
+    {
+        SharedArena writer(SM_DATA_PATH, 16 * 1024 * 1024);
+        auto points = writer.find_or_construct<SharedVector<Point>>("cloud", writer);
+        auto text   = writer.find_or_construct<SharedString>("label", writer);
+        for(size_t i = 0; i < POINTS; i++)
+        {
+            Point p = { 1.0f * i, 2.0f * i, 3.0f * i };
+            points->push_back(p);
+        }
+        *text = std::string("point cloud");
+        *text += " from child";
+        _exit(0);
+    }
+    wait(nullptr);
+
+    if(cloud->size() != POINTS || label->str() != "point cloud from child")
+    {
+        std::cout << "size error : " << cloud->size() << " " << label->c_str() << std::endl;
+        return 1;
+    }
+    for(size_t i = 0; i < POINTS; i++)
+    {
+        if((*cloud)[i].x != 1.0f * i || (*cloud)[i].z != 3.0f * i)
+        {
+            std::cout << "data error : " << i << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "read  success : " << cloud->size() << " points, label : " << label->c_str() << std::endl;
+
+    // 解放した領域は同じサイズクラスの確保で再利用される。
+    arena.deallocate(arena.allocate(100));
+    auto used = arena.used();
+    for(int i = 0; i < 1000; i++)
+    {
+        void* p = arena.allocate(100 + i % 20);
+        arena.deallocate(p);
+    }
+    if(arena.used() != used)
+    {
+        std::cout << "free list error : " << arena.used() - used << std::endl;
+        return 1;
+    }
+    std::cout << "reuse success" << std::endl;
+
+    // 最大のサイズクラスを超える確保、及び登録数上限の異なる接続は例外となる。
+    bool is_thrown = false;
+    try { arena.allocate(SIZE_MAX); } catch(const std::runtime_error&) { is_thrown = true; }
+    if(!is_thrown)
+    {
+        std::cout << "size class error" << std::endl;
+        return 1;
+    }
+    is_thrown = false;
+    try { SharedArena other(SM_DATA_PATH, 16 * 1024 * 1024, 32); } catch(const std::runtime_error&) { is_thrown = true; }
+    if(!is_thrown)
+    {
+        std::cout << "root capacity error" << std::endl;
+        return 1;
+    }
+    std::cout << "validation success" << std::endl;
+    return 0;
+}
@@ -29,6 +29,10 @@ int main()
     // 第二引数 : 確保するサイズ(共通変数としたい構造体のサイズ)
     auto shared_memory = SharedMemory(SM_DATA_PATH, sizeof(Sample));
 
+    // 最新値のみを共有し、書込側が読込側を待たない場合は第三引数に排他制御方式を指定する(読込側は上書きを検出して再試行する)。
+    // 書込側・読込側で同じ排他制御方式を指定すること。
+    // auto shared_memory = SharedMemory(SM_DATA_PATH, sizeof(Sample), SharedMemory::TRIPLE_BUFFER);
+
     // 共有したい変数のインスタンス
     auto sample_data = Sample();
 
@@ -56,7 +60,14 @@ int main()
         // 第一引数：タイマー周期(ミリ秒)
         // コンストラクト⇒デストラクトの実行時間を比較し、
         // 設定周期に満たない場合自動で待機する。
-        auto timer = ProcessTimer(500);  
+        auto timer = ProcessTimer(500);
+
+        // SEMAPHORE 以外の排他制御方式では、周期待機の代わりに書込側の更新を待機できる。
+        // 前回読込時の更新番号を保持しておき、更新がなければ読込を省略する。
+        // static uint32_t version = 0;
+        // if(!shared_memory.wait_for_update(version, 500))
+        //     continue;
+        // version = shared_memory.version();
 
         // 書込処理 try_read
         // 第一引数 : 読込変数(参照orポインタ)
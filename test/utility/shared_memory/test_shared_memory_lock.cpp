@@ -0,0 +1,289 @@
+/**
+ * @file test_shared_memory_lock.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedMemory の排他制御方式(SEQLOCK, FUTEX, RW_LOCK, TRIPLE_BUFFER)のプロセス間テストコード
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note 書込プロセスと読込プロセスを fork し、以下を確認する。
+ * @n 1. 読込側が書込途中のデータ(全要素が同一の通番でないデータ)を読み取らないこと
+ * @n 2. 他の書込側がビューを保持している間、タイムアウト指定の読込・書込が指定時間で失敗すること
+ * @n 3. RW_LOCK で読込側が共有ロックを取り続けても、書込側が一定時間内にロックを取得できること
+ * @n 4. TRIPLE_BUFFER で書込側が最大速度で書き込んでも、読込側の再試行が上限で打ち切られ、成功した読込は書込途中のデータを含まないこと
+ */
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <memory>
+#include <algorithm>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "utility/shared_memory.hpp"
+
+namespace
+{
+
+using Utility::SharedMemory;
+using Clock = std::chrono::steady_clock;
+
+/** 全要素に同一の通番を書き込む計測用の構造体 */
+struct Block
+{
+    uint64_t value[512];
+};
+
+static constexpr uint64_t COUNT   = 50000;
+static constexpr int      READERS = 2;
+
+void fill(Block& block, const uint64_t& value)
+{
+    for(auto& v : block.value)
+        v = value;
+}
+
+bool is_consistent(const Block& block)
+{
+    for(const auto& v : block.value)
+        if(v != block.value[0])
+            return false;
+    return true;
+}
+
+int64_t elapsed_msec(const Clock::time_point& start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+/** 子プロセスの終了を待ち、全て正常終了した場合 true を返す。 */
+bool wait_children()
+{
+    bool is_ok = true;
+    int status;
+    while(wait(&status) > 0)
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            is_ok = false;
+    return is_ok;
+}
+
+/** 書込プロセス1つと読込プロセス複数で、読込側が書込途中のデータを読まないことを確認する。 */
+bool test_consistency(const std::string& name, const SharedMemory::LockType& mode)
+{
+    SharedMemory shmem(name.c_str(), sizeof(Block), mode);
+    Block block;
+    fill(block, 0);
+    shmem.try_write(block);
+
+    for(int i = 0; i < READERS; i++)
+    {
+        if(fork() != 0)
+            continue;
+        SharedMemory reader(name.c_str(), sizeof(Block), mode);
+        Block data;
+        uint64_t torn = 0;
+        auto start = Clock::now();
+        do
+        {
+            if(!reader.try_read(data, 1000))
+                _exit(2);
+            if(!is_consistent(data))
+                torn++;
+            if(elapsed_msec(start) > 30000)
+                _exit(3);
+        }
+        while(data.value[0] < COUNT);
+        _exit(torn == 0 ? 0 : 1);
+    }
+
+    if(fork() == 0)
+    {
+        SharedMemory writer(name.c_str(), sizeof(Block), mode);
+        Block data;
+        for(uint64_t v = 1; v <= COUNT; v++)
+        {
+            fill(data, v);
+            if(!writer.try_write(data, 1000))
+                _exit(1);
+        }
+        _exit(0);
+    }
+
+    return wait_children();
+}
+
+/** 他の書込側がビューを保持している間、タイムアウト指定の読込・書込が指定時間で失敗することを確認する。 */
+bool test_timeout(const std::string& name, const SharedMemory::LockType& mode)
+{
+    static constexpr int TIMEOUT_MSEC = 50;
+
+    SharedMemory holder(name.c_str(), sizeof(Block), mode);
+    Block block;
+    fill(block, 1);
+    holder.try_write(block);
+
+    auto view = holder.write_view<Block>();
+    if(!view)
+        return false;
+
+    // 別プロセスから書込中の共有メモリへアクセスする。
+    if(fork() == 0)
+    {
+        SharedMemory other(name.c_str(), sizeof(Block), mode);
+        Block data;
+        fill(data, 2);
+        auto start = Clock::now();
+        if(other.try_read(data, TIMEOUT_MSEC))
+            _exit(1);
+        auto read_msec = elapsed_msec(start);
+        start = Clock::now();
+        if(other.try_write(data, TIMEOUT_MSEC))
+            _exit(2);
+        auto write_msec = elapsed_msec(start);
+        if(read_msec < TIMEOUT_MSEC - 5 || read_msec > TIMEOUT_MSEC * 10)
+            _exit(3);
+        if(write_msec < TIMEOUT_MSEC - 5 || write_msec > TIMEOUT_MSEC * 10)
+            _exit(4);
+        _exit(0);
+    }
+    bool is_ok = wait_children();
+    view.release();
+
+    // 解放後は読込・書込とも成功すること
+    return is_ok && holder.try_read(block, TIMEOUT_MSEC) && holder.try_write(block, TIMEOUT_MSEC);
+}
+
+/** RW_LOCK で読込側が共有ロックを取り続けても、書込側が飢餓状態にならないことを確認する。 */
+bool test_writer_preference(const std::string& name)
+{
+    static constexpr int WRITES         = 200;
+    static constexpr int MAX_WAIT_MSEC  = 1000;
+
+    SharedMemory shmem(name.c_str(), sizeof(Block), SharedMemory::RW_LOCK);
+    Block block;
+    fill(block, 0);
+    shmem.try_write(block);
+
+    for(int i = 0; i < READERS; i++)
+    {
+        if(fork() != 0)
+            continue;
+        SharedMemory reader(name.c_str(), sizeof(Block), SharedMemory::RW_LOCK);
+        // 読込側同士のビューの保持期間を重ね、共有ロックが途切れないようにする。
+        while(true)
+        {
+            auto view = reader.read_view<Block>(MAX_WAIT_MSEC * 5);
+            if(!view)
+                _exit(1);
+            if(view->value[0] == (uint64_t)WRITES)
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        _exit(0);
+    }
+
+    // 読込側が共有ロックを取り始めるのを待つ。
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    int64_t max_wait = 0;
+    bool is_ok = true;
+    for(int v = 1; v <= WRITES; v++)
+    {
+        fill(block, v);
+        auto start = Clock::now();
+        if(!shmem.try_write(block, MAX_WAIT_MSEC))
+        {
+            is_ok = false;
+            break;
+        }
+        max_wait = std::max(max_wait, elapsed_msec(start));
+    }
+    if(!is_ok)
+    {
+        // 読込側を終了させるため、停止値を書き込む。
+        fill(block, WRITES);
+        shmem.try_write(block);
+    }
+    std::cout << "  writer max wait : " << max_wait << " msec" << std::endl;
+    return wait_children() && is_ok;
+}
+
+/** TRIPLE_BUFFER の読込側が最大速度の書込側に対して待ち続けないことを確認する。 */
+bool test_triple_buffer(const std::string& name)
+{
+    static constexpr int DURATION_MSEC = 300;
+    static constexpr int MAX_READ_MSEC = 100;
+
+    // コピーに時間がかかるよう大きめの構造体を使用する。
+    struct Large { Block blocks[64]; };
+    SharedMemory shmem(name.c_str(), sizeof(Large), SharedMemory::TRIPLE_BUFFER);
+    std::unique_ptr<Large> data(new Large());
+
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+        SharedMemory writer(name.c_str(), sizeof(Large), SharedMemory::TRIPLE_BUFFER);
+        std::unique_ptr<Large> local(new Large());
+        auto start = Clock::now();
+        for(uint64_t v = 1; elapsed_msec(start) < DURATION_MSEC; v++)
+        {
+            for(auto& block : local->blocks)
+                fill(block, v);
+            writer.try_write(*local);
+        }
+        _exit(0);
+    }
+
+    bool is_ok = true;
+    uint64_t success = 0, failure = 0;
+    auto start = Clock::now();
+    while(elapsed_msec(start) < DURATION_MSEC)
+    {
+        auto read_start = Clock::now();
+        bool is_read    = shmem.try_read(*data);
+        if(elapsed_msec(read_start) > MAX_READ_MSEC)
+            is_ok = false;
+        if(!is_read)
+        {
+            failure++;
+            continue;
+        }
+        success++;
+        for(const auto& block : data->blocks)
+            if(!is_consistent(block) || block.value[0] != data->blocks[0].value[0])
+                is_ok = false;
+    }
+    std::cout << "  reads : " << success << " retry limit : " << failure << std::endl;
+    return wait_children() && is_ok && success > 0;
+}
+
+}
+
+int main()
+{
+    struct Mode { const char* name; SharedMemory::LockType type; };
+    const Mode modes[] = { { "SEQLOCK", SharedMemory::SEQLOCK }, { "FUTEX", SharedMemory::FUTEX }, { "RW_LOCK", SharedMemory::RW_LOCK } };
+
+    int failures = 0;
+    auto check = [&](const std::string& label, const bool& is_ok)
+    {
+        std::cout << label << " : " << (is_ok ? "OK" : "NG") << std::endl;
+        if(!is_ok)
+            failures++;
+    };
+
+    std::string prefix = "TEST_SM_LOCK_" + std::to_string(getpid()) + "_";
+    for(const auto& mode : modes)
+    {
+        check(std::string(mode.name) + " consistency", test_consistency(prefix + mode.name + "_C", mode.type));
+        check(std::string(mode.name) + " timeout", test_timeout(prefix + mode.name + "_T", mode.type));
+    }
+    check("RW_LOCK writer preference", test_writer_preference(prefix + "RW_LOCK_W"));
+    check("TRIPLE_BUFFER bounded retry", test_triple_buffer(prefix + "TRIPLE_BUFFER"));
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_shared_memory_persistence.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedMemory の生成方式(POSIX, MAPPED_FILE)と書込履歴のテストコード
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ * @note 以下を確認する。
+ * @n 1. POSIX の共有メモリが生成したプロセスの切断後も残り、最後のプロセスの切断で削除されること
+ * @n 2. try_read_history が M 件の書込のうち直近 history_depth 件を書込時刻付きで古い順に返すこと
+ * @n 3. MAPPED_FILE の共有メモリが再接続時に前回の内容を引き継ぎ、ヘッダーのチェックサムが一致しない場合は初期化し直すこと
+ */
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "utility/shared_memory.hpp"
+
+namespace
+{
+
+using Utility::SharedMemory;
+
+struct Record
+{
+    uint64_t key;
+    uint64_t value[31];
+};
+
+Record make_record(const uint64_t& key)
+{
+    Record record;
+    record.key = key;
+    for(auto& v : record.value)
+        v = key;
+    return record;
+}
+
+bool is_exist(const std::string& path)
+{
+    return access(path.c_str(), F_OK) == 0;
+}
+
+bool wait_child(const pid_t& pid)
+{
+    int status;
+    return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/** POSIX の共有メモリが最後のプロセスの切断まで残ることを確認する。 */
+bool test_posix_lifetime(const std::string& name)
+{
+    SharedMemory::MapOption option;
+    option.backend = SharedMemory::POSIX;
+    std::string path = "/dev/shm/" + name;
+
+    int attached[2], detached[2];
+    if(pipe(attached) != 0 || pipe(detached) != 0)
+        return false;
+
+    pid_t pid;
+    {
+        SharedMemory creator(name.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+        creator.try_write(make_record(42));
+
+        pid = fork();
+        if(pid == 0)
+        {
+            // 最後の切断で削除されるよう、_exit の前にデストラクタで切断する。
+            int result = 0;
+            {
+                SharedMemory child(name.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+                char c = 0;
+                Record record;
+                // 接続を通知し、生成したプロセスの切断を待つ。
+                if(write(attached[1], &c, 1) != 1 || read(detached[0], &c, 1) != 1)
+                    result = 1;
+                else if(!child.try_read(record, 100) || record.key != 42 || record.value[30] != 42)
+                    result = 2;
+                else if(!is_exist(path))
+                    result = 3;
+            }
+            _exit(result);
+        }
+        char c;
+        if(read(attached[0], &c, 1) != 1)
+            return false;
+    }
+
+    char c = 0;
+    bool is_ok = (write(detached[1], &c, 1) == 1) && wait_child(pid);
+    for(auto fd : { attached[0], attached[1], detached[0], detached[1] })
+        close(fd);
+    return is_ok && !is_exist(path);
+}
+
+/** 別プロセスで M 件書き込み、直近 N 件が書込時刻付きで読めることを確認する。 */
+bool test_history(const std::string& name)
+{
+    static constexpr size_t   DEPTH  = 8;
+    static constexpr uint64_t WRITES = 20;
+
+    SharedMemory::MapOption option;
+    option.history_depth = DEPTH;
+    SharedMemory shmem(name.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+
+    int64_t begin = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+        SharedMemory writer(name.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+        for(uint64_t key = 1; key <= WRITES; key++)
+            writer.try_write(make_record(key));
+        _exit(0);
+    }
+    if(!wait_child(pid))
+        return false;
+    int64_t end = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    uint64_t since = 0;
+    Record records[DEPTH * 2];
+    int64_t timestamps[DEPTH * 2];
+    size_t count = shmem.try_read_history(since, records, DEPTH * 2, timestamps);
+    if(count != DEPTH || since != WRITES || shmem.history_count() != WRITES)
+        return false;
+    for(size_t i = 0; i < count; i++)
+    {
+        if(records[i].key != WRITES - DEPTH + 1 + i || records[i].value[30] != records[i].key)
+            return false;
+        if(timestamps[i] < begin || timestamps[i] > end || (i > 0 && timestamps[i] < timestamps[i - 1]))
+            return false;
+    }
+
+    // 読み込み済みの履歴番号以降に書込が無ければ 0 件となる。
+    return shmem.try_read_history(since, records, DEPTH * 2) == 0;
+}
+
+/** MAPPED_FILE の再接続時に前回の内容を引き継ぎ、チェックサム不一致では初期化し直すことを確認する。 */
+bool test_mapped_file(const std::string& path)
+{
+    SharedMemory::MapOption option;
+    option.backend = SharedMemory::MAPPED_FILE;
+    option.history_depth = 4;
+    unlink(path.c_str());
+
+    {
+        SharedMemory shmem(path.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+        shmem.try_write(make_record(7));
+    }
+
+    // 書込中に異常終了したプロセスが残したロックは再接続時に解除される。
+    pid_t pid = fork();
+    if(pid == 0)
+    {
+        SharedMemory shmem(path.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+        auto view = shmem.write_view<Record>();
+        *view = make_record(8);
+        _exit(0);
+    }
+    if(!wait_child(pid))
+        return false;
+
+    {
+        SharedMemory shmem(path.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+        Record record;
+        uint64_t since = 0;
+        Record history[4];
+        if(!shmem.try_read(record, 100) || record.key != 8)
+            return false;
+        if(shmem.try_read_history(since, history, 4) != 1 || history[0].key != 7)
+            return false;
+        if(!shmem.try_write(make_record(9), 100))
+            return false;
+    }
+
+    // ヘッダーのチェックサム(Header::checksum 先頭から 32 バイト目)を書き換える。
+    FILE* file = std::fopen(path.c_str(), "r+b");
+    if(file == nullptr)
+        return false;
+    std::fseek(file, 32, SEEK_SET);
+    int c = std::fgetc(file);
+    std::fseek(file, 32, SEEK_SET);
+    std::fputc(c ^ 0xFF, file);
+    std::fclose(file);
+
+    bool is_ok;
+    {
+        SharedMemory shmem(path.c_str(), sizeof(Record), SharedMemory::SEQLOCK, option);
+        Record record;
+        is_ok = shmem.try_read(record, 100) && record.key == 0 && shmem.history_count() == 0;
+    }
+    unlink(path.c_str());
+    unlink((path + ".lock").c_str());
+    return is_ok;
+}
+
+}
+
+int main()
+{
+    int failures = 0;
+    auto check = [&](const std::string& label, const bool& is_ok)
+    {
+        std::cout << label << " : " << (is_ok ? "OK" : "NG") << std::endl;
+        if(!is_ok)
+            failures++;
+    };
+
+    std::string prefix = "TEST_SM_PERSIST_" + std::to_string(getpid()) + "_";
+    check("POSIX lifetime", test_posix_lifetime(prefix + "POSIX"));
+    check("history", test_history(prefix + "HISTORY"));
+    check("MAPPED_FILE reattach", test_mapped_file("/tmp/" + prefix + "MAPPED.dat"));
+
+    return failures == 0 ? 0 : 1;
+}
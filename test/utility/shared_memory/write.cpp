@@ -29,6 +29,10 @@ int main()
     // 第二引数 : 確保するサイズ(共通変数としたい構造体のサイズ)
     auto shared_memory = SharedMemory(SM_DATA_PATH, sizeof(Sample));
 
+    // 最新値のみを共有し、書込側が読込側を待たない場合は第三引数に排他制御方式を指定する(読込側は上書きを検出して再試行する)。
+    // 書込側・読込側で同じ排他制御方式を指定すること。
+    // auto shared_memory = SharedMemory(SM_DATA_PATH, sizeof(Sample), SharedMemory::TRIPLE_BUFFER);
+
     // 先に起動するプロセスでのみ実行
     // 前回終了時にロックがかかった状態でプロセスを停止した場合を考慮したデッドロック対策
     // shared_memory.flush();
@@ -0,0 +1,14 @@
+#ifndef _TEST_UTILITY_SHARED_MEMORY_BRIDGE_SAMPLE_DATA_HPP_
+#define _TEST_UTILITY_SHARED_MEMORY_BRIDGE_SAMPLE_DATA_HPP_
+
+struct Sample
+{
+    unsigned long sequence;
+    double values[4096];
+};
+
+static constexpr char SM_SOURCE_PATH[32] = "SAMPLE_BRIDGE_SOURCE";
+static constexpr char SM_MIRROR_PATH[32] = "SAMPLE_BRIDGE_MIRROR";
+static constexpr int BRIDGE_PORT = 8010;
+
+#endif
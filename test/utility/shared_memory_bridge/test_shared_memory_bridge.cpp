@@ -0,0 +1,85 @@
+/**
+ * @file test_shared_memory_bridge.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedMemoryBridge のテストコード及びクライアントコード例
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+#include "./sample_data.hpp"
+#include "utility/shared_memory_bridge.hpp"
+
+int main()
+{
+    using Utility::SharedMemory;
+    using Utility::UdpSocket;
+
+    static constexpr int CYCLES = 1000;
+    static constexpr int KEYFRAME_INTERVAL = 100;
+
+    // 複製元・複製先の共有メモリ 実運用では別ホスト上に配置する。
+    SharedMemory source(SM_SOURCE_PATH, sizeof(Sample), SharedMemory::SEQLOCK);
+    SharedMemory mirror(SM_MIRROR_PATH, sizeof(Sample), SharedMemory::SEQLOCK);
+
+    UdpSocket send_socket;
+    send_socket.set_target_ports(std::vector<int>{ BRIDGE_PORT });
+    UdpSocket recv_socket;
+    recv_socket.set_listen_port(BRIDGE_PORT).set_timeout(1000);
+
+    // 送信側 第三引数 : キーフレーム周期(update 呼出回数) 第四引数 : 1パケットの最大サイズ
+    Utility::SharedMemoryBridge::Sender<Sample> sender(source, send_socket, KEYFRAME_INTERVAL, 1400);
+    // 受信側
+    Utility::SharedMemoryBridge::Receiver<Sample> receiver(mirror, recv_socket);
+
+    static Sample sample, copy;
+    uint64_t discarded = 0;
+    std::memset(&sample, 0, sizeof(Sample));
+    for(int cycle = 0; cycle < CYCLES; cycle++)
+    {
+        // 1周期毎に構造体の一部のみを更新する。
+        sample.sequence = cycle;
+        sample.values[(cycle * 7) % 4096] = cycle;
+        source.try_write(sample);
+        sender.update();
+
+        // 周期 250～259 は受信せずに破棄し、パケットの欠落を模擬する。
+        if(cycle >= 250 && cycle < 260)
+        {
+            char discard[1500];
+            int length;
+            while(receiver.received_packets() + discarded < sender.sent_packets())
+                if(recv_socket.try_read_datagram(discard, sizeof(discard), length))
+                    discarded++;
+            continue;
+        }
+
+        // フレームを構成する全パケットを受信すると共有メモリへ反映される。
+        while(receiver.received_packets() + discarded < sender.sent_packets())
+            receiver.update();
+
+        mirror.try_read(copy);
+        bool same = std::memcmp(&sample, &copy, sizeof(Sample)) == 0;
+        if(receiver.synced() != same)
+        {
+            std::cout << "mirror error : cycle " << cycle << std::endl;
+            return 1;
+        }
+        // 欠落後は次のキーフレーム(周期 300)まで反映を停止する。
+        if(receiver.synced() == (cycle > 250 && cycle < 300))
+        {
+            std::cout << "sync state error : cycle " << cycle << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "lost packets : " << receiver.lost() << std::endl;
+    std::cout << "sent bytes   : " << sender.sent_bytes() << " (full copy : " << (unsigned long)CYCLES * sizeof(Sample) << ")" << std::endl;
+    return 0;
+}
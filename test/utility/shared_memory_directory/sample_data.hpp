@@ -0,0 +1,21 @@
+#ifndef _TEST_UTILITY_SHARED_MEMORY_DIRECTORY_SAMPLE_DATA_HPP_
+#define _TEST_UTILITY_SHARED_MEMORY_DIRECTORY_SAMPLE_DATA_HPP_
+
+struct Position
+{
+    unsigned long sequence;
+    double x;
+    double y;
+    double z;
+};
+
+struct Status
+{
+    unsigned long sequence;
+    int mode;
+    char message[100];
+};
+
+static constexpr char SM_DATA_PATH[32] = "SAMPLE_DIRECTORY";
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file test_shared_memory_directory.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedMemoryDirectory クラスのテストコード及びクライアントコード例
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "./sample_data.hpp"
+#include "utility/shared_memory_directory.hpp"
+
+int main()
+{
+    using Utility::SharedMemoryDirectory;
+
+    static constexpr unsigned long COUNT = 100000;
+    static constexpr int CHANNELS = 16;
+
+    // 1つの共有メモリ上にチャネルを配置するディレクトリを生成
+    // 第一引数 : 共有メモリ名
+    // 第二引数 : チャネルに割り当てる領域の合計サイズ
+    // 第三引数 : 登録できるチャネル数(省略可能)
+    SharedMemoryDirectory directory(SM_DATA_PATH, 64 * 1024, 32);
+
+    // 子プロセスを書込側とする。
+    if(fork() == 0)
+    {
+        SharedMemoryDirectory writer(SM_DATA_PATH, 64 * 1024, 32);
+
+        // チャネルの取得 名前の検索は取得時のみ行い、以降はハンドルを使用する。
+        auto position = writer.channel<Position>("position");
+        auto status   = writer.channel<Status>("status");
+        for(unsigned long i = 1; i <= COUNT; i++)
+        {
+            Position p = { i, 1.0 * i, 2.0 * i, 3.0 * i };
+            position.try_write(p);
+            if(i % 100 == 0)
+            {
+                Status s = { i, (int)(i / 100), "running" };
+                status.try_write(s);
+            }
+        }
+        for(int c = 0; c < CHANNELS; c++)
+        {
+            Position p = { (unsigned long)c, 0.0, 0.0, 0.0 };
+            writer.channel<Position>(("channel_" + std::to_string(c)).c_str()).try_write(p);
+        }
+        _exit(0);
+    }
+
+    auto position = directory.channel<Position>("position");
+    auto status   = directory.channel<Status>("status");
+    unsigned long last = 0;
+    while(last < COUNT)
+    {
+        Position p;
+        if(!position.try_read(p, 1000))
+            continue;
+        if(p.x != 1.0 * p.sequence || p.y != 2.0 * p.sequence || p.z != 3.0 * p.sequence || p.sequence < last)
+        {
+            std::cout << "torn read : " << p.sequence << std::endl;
+            return 1;
+        }
+        last = p.sequence;
+    }
+    wait(nullptr);
+
+    Status s;
+    status.try_read(s);
+    if(s.sequence != COUNT || std::string(s.message) != "running")
+    {
+        std::cout << "status error : " << s.sequence << std::endl;
+        return 1;
+    }
+    for(int c = 0; c < CHANNELS; c++)
+    {
+        Position p;
+        directory.channel<Position>(("channel_" + std::to_string(c)).c_str()).try_read(p);
+        if(p.sequence != (unsigned long)c)
+        {
+            std::cout << "channel error : " << c << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "read  success : " << directory.size() << " channels" << std::endl;
+
+    // 同名のチャネルを異なる型で取得すると例外を送出する。
+    try
+    {
+        directory.channel<Status>("position");
+        std::cout << "type mismatch was not detected" << std::endl;
+        return 1;
+    }
+    catch(const std::runtime_error& e)
+    {
+        std::cout << "type mismatch detected" << std::endl;
+    }
+
+    // 複数チャネルの同時更新 子プロセスはトランザクションで position, status を同じ番号で公開する。
+    if(fork() == 0)
+    {
+        SharedMemoryDirectory writer(SM_DATA_PATH, 64 * 1024, 32);
+        auto position = writer.channel<Position>("position");
+        auto status   = writer.channel<Status>("status");
+
+        // インスタンスを使い回すことで周期毎の動的確保を避ける。
+        SharedMemoryDirectory::Transaction transaction(writer);
+        for(unsigned long i = COUNT + 1; i <= 2 * COUNT; i++)
+        {
+            Position p = { i, 1.0 * i, 2.0 * i, 3.0 * i };
+            Status s   = { i, (int)(i / 100), "transaction" };
+            transaction.write(position, p);
+            transaction.write(status, s);
+            transaction.commit();
+        }
+        _exit(0);
+    }
+
+    last = COUNT;
+    while(last < 2 * COUNT)
+    {
+        Position p;
+        Status s;
+        // 読込中に公開があれば読み直すため、2つのチャネルは常に同じ番号となる。
+        if(!directory.read_consistent([&](){ position.try_read(p); status.try_read(s); }, 1000))
+            continue;
+        if(p.sequence != s.sequence)
+        {
+            std::cout << "inconsistent transaction : " << p.sequence << " " << s.sequence << std::endl;
+            return 1;
+        }
+        last = p.sequence;
+    }
+    wait(nullptr);
+    std::cout << "transaction success : epoch " << directory.epoch() << std::endl;
+    return 0;
+}
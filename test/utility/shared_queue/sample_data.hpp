@@ -0,0 +1,13 @@
+#ifndef _TEST_UTILITY_SHARED_QUEUE_SAMPLE_DATA_HPP_
+#define _TEST_UTILITY_SHARED_QUEUE_SAMPLE_DATA_HPP_
+
+struct Sample
+{
+    int producer;
+    unsigned long sequence;
+    double d_data;
+};
+
+static constexpr char SM_DATA_PATH[32] = "SAMPLE_QUEUE";
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * @file test_shared_queue.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedQueue クラスのテストコード及びクライアントコード例
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <iostream>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "./sample_data.hpp"
+#include "utility/shared_queue.hpp"
+
+int main()
+{
+    using Utility::SharedQueue;
+
+    static constexpr int PRODUCERS = 4;
+    static constexpr unsigned long COUNT = 200000;
+
+    // 共有メモリ上に 4096 要素のキューを生成
+    // 第一引数 : 共有メモリ名
+    // 第二引数 : キューの要素数(2のべき乗に切り上げ)
+    SharedQueue<Sample> queue(SM_DATA_PATH, 4096);
+
+    // 子プロセスを書込側とする。
+    for(int p = 0; p < PRODUCERS; p++)
+    {
+        if(fork() != 0)
+            continue;
+
+        SharedQueue<Sample> writer(SM_DATA_PATH, 4096);
+        Sample buffer[8];
+        unsigned long sequence = 0;
+        while(sequence < COUNT)
+        {
+            if(sequence % 2)
+            {
+                // 1要素の書込 push キューに空きができるまで待機する。
+                Sample sample = { p, sequence, 1.1 * sequence };
+                writer.push(sample);
+                sequence++;
+                continue;
+            }
+            size_t count = 0;
+            for(; count < 8 && sequence + count < COUNT; count++)
+                buffer[count] = { p, sequence + count, 1.1 * (sequence + count) };
+            // 一括書込 try_push 戻り値は書き込んだ要素数
+            sequence += writer.try_push(buffer, count);
+        }
+        _exit(0);
+    }
+
+    // 親プロセスが全書込側のデータを集約する。
+    std::vector<unsigned long> expected(PRODUCERS, 0);
+    unsigned long total = 0;
+    Sample buffer[32];
+    while(total < PRODUCERS * COUNT)
+    {
+        auto n = queue.try_pop(buffer, 32);
+        for(size_t i = 0; i < n; i++, total++)
+        {
+            if(buffer[i].sequence != expected[buffer[i].producer]++)
+            {
+                std::cout << "order error : producer " << buffer[i].producer << std::endl;
+                return 1;
+            }
+        }
+        // 1要素の読込 pop タイムアウト(ミリ秒)を指定できる。
+        if(n == 0 && queue.pop(buffer[0], 1000))
+        {
+            if(buffer[0].sequence != expected[buffer[0].producer]++)
+            {
+                std::cout << "order error : producer " << buffer[0].producer << std::endl;
+                return 1;
+            }
+            total++;
+        }
+    }
+    std::cout << "read  success : " << total << " messages" << std::endl;
+
+    while(wait(nullptr) > 0);
+    return 0;
+}
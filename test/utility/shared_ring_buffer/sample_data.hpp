@@ -0,0 +1,12 @@
+#ifndef _TEST_UTILITY_SHARED_RING_BUFFER_SAMPLE_DATA_HPP_
+#define _TEST_UTILITY_SHARED_RING_BUFFER_SAMPLE_DATA_HPP_
+
+struct Sample
+{
+    unsigned long sequence;
+    double d_data;
+};
+
+static constexpr char SM_DATA_PATH[32] = "SAMPLE_RING";
+
+#endif
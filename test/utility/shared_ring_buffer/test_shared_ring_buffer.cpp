@@ -0,0 +1,73 @@
+/**
+ * @file test_shared_ring_buffer.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief @ref Utility::SharedRingBuffer クラスのテストコード及びクライアントコード例
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+
+#include <iostream>
+#include <cstdlib>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "./sample_data.hpp"
+#include "utility/shared_ring_buffer.hpp"
+
+int main()
+{
+    using Utility::SharedRingBuffer;
+
+    static constexpr unsigned long COUNT = 1000000;
+
+    // 共有メモリ上に 1024 要素のキューを生成
+    // 第一引数 : 共有メモリ名
+    // 第二引数 : キューの要素数(2のべき乗に切り上げ)
+    SharedRingBuffer<Sample> queue(SM_DATA_PATH, 1024);
+
+    // 子プロセスを読込側とする。
+    if(fork() == 0)
+    {
+        SharedRingBuffer<Sample> reader(SM_DATA_PATH, 1024);
+        Sample buffer[64];
+        unsigned long expected = 0;
+        while(expected < COUNT)
+        {
+            // 一括読込 try_pop 戻り値は読み取った要素数
+            auto n = reader.try_pop(buffer, 64);
+            for(size_t i = 0; i < n; i++, expected++)
+            {
+                if(buffer[i].sequence != expected)
+                {
+                    std::cout << "order error : " << buffer[i].sequence << " != " << expected << std::endl;
+                    _exit(1);
+                }
+            }
+        }
+        std::cout << "read  success : " << expected << " messages" << std::endl;
+        _exit(0);
+    }
+
+    Sample buffer[16];
+    unsigned long sequence = 0;
+    while(sequence < COUNT)
+    {
+        size_t count = 0;
+        for(; count < 16 && sequence + count < COUNT; count++)
+        {
+            buffer[count].sequence = sequence + count;
+            buffer[count].d_data   = 1.1 * (sequence + count);
+        }
+        // 一括書込 try_push 戻り値は書き込んだ要素数(キューが満杯の場合は count 未満)
+        sequence += queue.try_push(buffer, count);
+    }
+    std::cout << "write success : " << sequence << " messages" << std::endl;
+
+    int status;
+    wait(&status);
+    return WEXITSTATUS(status);
+}
@@ -0,0 +1,75 @@
+#include <iostream>                     // std::cout, std::endl
+#include <vector>                       // std::vector
+
+#include "utility/udp_socket.hpp"       // Utility::UdpSocket
+#include "./sample_data.hpp"            // Sample
+
+int main()
+{
+    using Utility::UdpSocket;
+
+    static constexpr int BATCH = 32;
+
+    // 受信側 受信ポートに8002番ポートを指定
+    auto receiver = UdpSocket();
+    receiver.set_listen_port(8002).set_timeout(1000);
+
+    // 送信側 送信先に8002番ポートを指定
+    auto sender = UdpSocket();
+    sender.set_target_ports(std::vector<int>{8002});
+
+    // 送信するメッセージ 送信バッファ・サイズは呼出側で用意する。
+    std::vector<Sample> samples(BATCH);
+    std::vector<UdpSocket::Message> outgoing(BATCH);
+    for (int i = 0; i < BATCH; i++)
+    {
+        samples[i].i_data   = i;
+        outgoing[i].buffer  = (char *)&samples[i];
+        outgoing[i].length  = sizeof(Sample);
+    }
+
+    // 一括送信処理 try_write_batch
+    // 全送信先へ送信できたメッセージ数を返す。第三引数で送信先を1つに限定することもできる。
+    int sent = sender.try_write_batch(outgoing.data(), BATCH);
+    std::cout << "[Send]: " << sent << " messages" << std::endl;
+
+    // 受信バッファの用意 受信前に buffer, capacity を設定しておく。
+    std::vector<Sample> received(BATCH);
+    std::vector<UdpSocket::Message> incoming(BATCH);
+    for (int i = 0; i < BATCH; i++)
+    {
+        incoming[i].buffer   = (char *)&received[i];
+        incoming[i].capacity = sizeof(Sample);
+    }
+
+    // 一括受信処理 try_read_batch
+    // 1件目の到着を待機した後、到着済みのメッセージをまとめて受信し、受信数を返す。
+    // 各メッセージの length に受信サイズ、source に送信元、truncated に切り詰めの有無が設定される。
+    int total = 0;
+    while (total < sent)
+    {
+        int n = receiver.try_read_batch(incoming.data(), BATCH);
+        if (n == 0)
+            break;
+        for (int i = 0; i < n; i++)
+            std::cout << "[Recv]: i_data=" << received[i].i_data << " length=" << incoming[i].length
+                      << " port=" << ntohs(incoming[i].source.sin_port) << (incoming[i].truncated ? " truncated" : "") << std::endl;
+        total += n;
+    }
+    std::cout << "[Recv]: " << total << " messages" << std::endl;
+
+    // バッファプールを使用した受信
+    // 生成時に領域を確保しておき、受信処理中は動的確保・コピーを行わない。
+    // 第一引数 : スロット数(1回で受信する最大メッセージ数) 第二引数 : 1スロットのサイズ
+    auto pool = UdpSocket::BufferPool(BATCH, 2048);
+    sender.try_write_batch(outgoing.data(), BATCH);
+    total = 0;
+    while (total < BATCH && receiver.try_read(pool) > 0)
+    {
+        // 各メッセージの buffer はプール内を指し、次の受信まで有効。
+        for (const auto &message : pool)
+            std::cout << "[Pool]: i_data=" << ((const Sample *)message.buffer)->i_data << " length=" << message.length << std::endl;
+        total += pool.size();
+    }
+    std::cout << "[Pool]: " << total << " messages" << std::endl;
+}
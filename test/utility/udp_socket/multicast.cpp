@@ -0,0 +1,47 @@
+#include <iostream>                     // std::cout, std::endl
+#include <vector>                       // std::vector
+
+#include "utility/udp_socket.hpp"       // Utility::UdpSocket
+#include "./sample_data.hpp"            // Sample
+
+int main()
+{
+    using Utility::UdpSocket;
+
+    static constexpr char GROUP[] = "239.255.0.1";
+    static constexpr int PORT = 8005;
+    static constexpr int SUBSCRIBERS = 3;
+
+    // 購読側 同一ホスト上の複数ソケットで同じポートを受信するため、bind 前にアドレス再利用を設定する。
+    std::vector<UdpSocket> subscribers(SUBSCRIBERS);
+    for (auto &subscriber : subscribers)
+    {
+        subscriber.set_reuse_address().set_listen_port(PORT).set_timeout(1000);
+        // グループへの参加 第二引数で受信インターフェースの IP アドレスを指定できる。
+        subscriber.join_group(GROUP, "127.0.0.1");
+        // 送信元を限定する場合は join_source_group を使用する。
+        // subscriber.join_source_group(GROUP, "192.168.0.10");
+    }
+
+    // 配信側 送信先にグループアドレスを1つ指定すれば、1回の sendto で全購読者へ届く。
+    auto publisher = UdpSocket();
+    publisher.set_target_ports({{GROUP, PORT}});
+    publisher.set_multicast_interface("127.0.0.1")  // 送信インターフェース
+             .set_multicast_ttl(1)                  // 到達範囲(ルーター通過数)
+             .set_multicast_loopback(true);         // 自ホストの購読者にも配送する
+
+    auto sample_data = Sample();
+    sample_data.i_data = 123;
+    if (publisher.try_write(sample_data))
+        std::cout << "[Send]: OK" << std::endl;
+
+    for (auto &subscriber : subscribers)
+    {
+        auto received = Sample();
+        if (subscriber.try_read(received))
+            std::cout << "[Recv]: OK i_data=" << received.i_data << std::endl;
+        else
+            std::cout << "[Recv]: NG" << std::endl;
+        subscriber.leave_group(GROUP, "127.0.0.1");
+    }
+}
@@ -0,0 +1,52 @@
+#include <iostream>                     // std::cout, std::endl
+#include <vector>                       // std::vector
+#include <thread>                       // std::this_thread
+#include <chrono>                       // std::chrono
+
+#include "utility/udp_socket.hpp"       // Utility::UdpSocket
+#include "./sample_data.hpp"            // Sample
+
+int main()
+{
+    using Utility::UdpSocket;
+
+    static constexpr int COUNT = 100;
+
+    // 受信側 カーネル受信時刻の取得を有効にする。NIC のハードウェア時刻を使う場合は set_kernel_timestamp(true, true)
+    auto receiver = UdpSocket();
+    receiver.set_listen_port(8006).set_timeout(1000).set_kernel_timestamp();
+
+    auto sender = UdpSocket();
+    sender.set_target_ports(std::vector<int>{8006});
+
+    auto sample_data = Sample();
+    for (int i = 0; i < COUNT; i++)
+    {
+        sample_data.i_data = i;
+        sender.try_write(sample_data);
+    }
+
+    // ソケットバッファで待たされた時間が待ち時間として計測される。
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // Message で受信する API(try_read(Message&), try_read_batch, try_read(BufferPool&))が受信時刻・待ち時間を返す。
+    auto received = Sample();
+    UdpSocket::Message message = {};
+    message.buffer   = (char *)&received;
+    message.capacity = sizeof(Sample);
+    if (receiver.try_read(message))
+        std::cout << "[Recv]: i_data=" << received.i_data << " timestamp=" << message.timestamp_nsec
+                  << "nsec delay=" << message.delay_nsec / 1000 << "usec" << std::endl;
+
+    UdpSocket::BufferPool pool(COUNT, sizeof(Sample));
+    receiver.try_read(pool);
+
+    // 待ち時間の統計 ソケットバッファサイズ・受信スレッド優先度の調整に使用する。
+    auto stats = receiver.delay_stats();
+    std::cout << "[Delay]: count=" << stats.count
+              << " mean=" << (stats.count > 0 ? stats.total_nsec / stats.count / 1000 : 0) << "usec"
+              << " max=" << stats.max_nsec / 1000 << "usec" << std::endl;
+    for (size_t i = 0; i < UdpSocket::DELAY_BUCKETS; i++)
+        if (stats.histogram[i] > 0)
+            std::cout << "  < " << (1ul << i) << "usec : " << stats.histogram[i] << std::endl;
+}
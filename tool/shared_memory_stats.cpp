@@ -0,0 +1,188 @@
+/**
+ * @file shared_memory_stats.cpp
+ * @author okano tomoyuki (tomoyuki.okano@tsuneishi.com)
+ * @brief 既存の共有メモリに読込専用で接続し、@ref Utility::SharedMemory のロック統計を一覧表示するツール
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * @note 使用方法
+ * @n shared_memory_stats            System V 共有メモリ(/proc/sysvipc/shm)と POSIX 共有メモリ(/dev/shm)の全セグメントを表示する。
+ * @n shared_memory_stats path ...   指定したファイル(MAPPED_FILE 又は /dev/shm 配下)のみを表示する。
+ * @n SEMAPHORE の共有メモリは管理領域(ヘッダー)を持たず本クラスの共有メモリと判別できないため、他の共有メモリと合わせて対象外の件数のみ表示する。
+ * @n 統計は MapOption::statistics を有効にしたプロセスが接続した共有メモリのみ記録され、それ以外は "statistics disabled" と表示する。
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/shm.h>
+#include <sys/stat.h>
+
+#include "utility/shared_memory.hpp"
+
+namespace
+{
+
+using Utility::SharedMemory;
+
+const char* lock_type_name(const enum SharedMemory::LockType& lock_type)
+{
+    switch(lock_type)
+    {
+    case SharedMemory::SEMAPHORE:       return "SEMAPHORE";
+    case SharedMemory::SEQLOCK:         return "SEQLOCK";
+    case SharedMemory::NONE:            return "NONE";
+    case SharedMemory::FUTEX:           return "FUTEX";
+    case SharedMemory::TRIPLE_BUFFER:   return "TRIPLE_BUFFER";
+    case SharedMemory::RW_LOCK:         return "RW_LOCK";
+    }
+    return "UNKNOWN";
+}
+
+void print(const std::string& label, const SharedMemory::Stats& stats)
+{
+    double average_wait   = (stats.contended > 0) ? stats.total_wait_nsec / 1000.0 / stats.contended : 0.0;
+    std::cout << label << " lock=" << lock_type_name(stats.lock_type) << " size=" << stats.buffer_size << std::endl;
+    // 統計を記録していない場合は、競合の無い共有メモリと区別できるよう値を表示しない。
+    if(!stats.is_enabled)
+    {
+        std::cout << "  statistics disabled" << std::endl;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    // 競合しなかった読込側の取得回数は共有メモリ上に記録されないため、書込権の取得回数のみ表示する。
+    std::cout << "  write acquisitions : " << stats.acquisitions
+              << "  contended : " << stats.contended
+              << "  timeouts : " << stats.timeouts << std::endl;
+    std::cout << "  wait total : " << stats.total_wait_nsec / 1000.0 << " us"
+              << "  wait average : " << average_wait << " us"
+              << "  max hold : " << stats.max_hold_nsec / 1000.0 << " us" << std::endl;
+    std::cout << "  wait histogram :";
+    for(size_t i = 0; i < SharedMemory::STATS_BUCKETS; i++)
+    {
+        if(stats.wait_histogram[i] == 0)
+            continue;
+        if(i == 0)
+            std::cout << " <1us:";
+        else if(i == SharedMemory::STATS_BUCKETS - 1)
+            std::cout << " >=" << (1ull << (i - 1)) << "us:";
+        else
+            std::cout << " " << (1ull << (i - 1)) << "-" << (1ull << i) << "us:";
+        std::cout << stats.wait_histogram[i];
+    }
+    std::cout << std::endl;
+}
+
+/** System V 共有メモリを読込専用で接続して表示する。本クラスの共有メモリと判別できなかった件数を skipped に加算する。 */
+int dump_system_v(int& skipped)
+{
+    std::ifstream ifs("/proc/sysvipc/shm");
+    std::string line;
+    std::getline(ifs, line);                            // 見出し行
+    int count = 0;
+    while(std::getline(ifs, line))
+    {
+        std::istringstream iss(line);
+        long key;
+        int shmid;
+        std::string perms;
+        size_t size;
+        if(!(iss >> key >> shmid >> perms >> size))
+            continue;
+        void* mapping = shmat(shmid, nullptr, SHM_RDONLY);
+        if(mapping == (void*)-1)
+            continue;
+        SharedMemory::Stats stats;
+        if(SharedMemory::read_stats(mapping, size, stats))
+        {
+            std::ostringstream label;
+            label << "[System V] key=0x" << std::hex << std::setw(8) << std::setfill('0') << (uint32_t)key << std::dec << " shmid=" << shmid;
+            print(label.str(), stats);
+            count++;
+        }
+        else
+            skipped++;
+        shmdt(mapping);
+    }
+    return count;
+}
+
+/** ファイル(POSIX 共有メモリ又は MAPPED_FILE)を読込専用でマッピングして表示する。 */
+bool dump_file(const std::string& path, const std::string& kind)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd == -1)
+        return false;
+    struct stat st;
+    bool is_printed = false;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if(mapping != MAP_FAILED)
+        {
+            SharedMemory::Stats stats;
+            if(SharedMemory::read_stats(mapping, st.st_size, stats))
+            {
+                print("[" + kind + "] " + path, stats);
+                is_printed = true;
+            }
+            munmap(mapping, st.st_size);
+        }
+    }
+    close(fd);
+    return is_printed;
+}
+
+int dump_posix(int& skipped)
+{
+    DIR* dir = opendir("/dev/shm");
+    if(dir == nullptr)
+        return 0;
+    int count = 0;
+    while(struct dirent* entry = readdir(dir))
+    {
+        if(entry->d_name[0] == '.')
+            continue;
+        if(dump_file(std::string("/dev/shm/") + entry->d_name, "POSIX"))
+            count++;
+        else
+            skipped++;
+    }
+    closedir(dir);
+    return count;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    int count   = 0;
+    int skipped = 0;
+    if(argc > 1)
+    {
+        for(int i = 1; i < argc; i++)
+        {
+            if(dump_file(argv[i], "FILE"))
+                count++;
+            else
+                std::cerr << argv[i] << " : not a shared memory created by SharedMemory (or a SEMAPHORE one)." << std::endl;
+        }
+    }
+    else
+        count = dump_system_v(skipped) + dump_posix(skipped);
+
+    if(count == 0)
+        std::cout << "no shared memory created by SharedMemory found." << std::endl;
+    if(skipped > 0)
+        std::cout << skipped << " other segment(s) skipped (SEMAPHORE segments have no header and are not listed)." << std::endl;
+    return 0;
+}